@@ -4,11 +4,13 @@
 
 
 #include <complex.h>
+#include <stddef.h>
+#include <stdio.h>
 
 /**
  *  * \brief This macro is intended to help on matrixes algorithms
  * */ 
-#define M(i, j, number_of_columns , mat) mat[ i*number_of_columns + j ]
+#define M(i, j, number_of_columns , mat) mat[ (i)*(number_of_columns) + (j) ]
 
 #define BOOLEAN int
 #define TRUE 1
@@ -215,6 +217,18 @@ double* generate_random_double_matrix(
 	long int lines, 
 	long int columns);
 
+/**
+ * \brief Generates a random symmetric positive definite matrix
+ * 
+ * Symmetric, with off-diagonal values between 0 and order - 1 and each
+ * diagonal element larger than the sum of the other elements of its line
+ * (strictly diagonally dominant with a positive diagonal, so SPD and well
+ * conditioned). Both triangles are stored.
+ * 
+ * The programmer MUST free the allocated memory after its use!
+ * */
+double* generate_random_spd_matrix(long int order);
+
 /**
  * \brief Saves a double matrix pointed by data on a specified filename
  * 
@@ -246,6 +260,40 @@ double* load_double_matrix(const char *filename,
 	long int number_of_columns
 	);
 
+/**
+ * \brief Generates a random float matrix
+ * 
+ * Same values as generate_random_double_matrix(), stored as float (so
+ * values above 2^24 are rounded).
+ * 
+ * The programmer MUST free the allocated memory after its use!
+ * */
+float* generate_random_float_matrix( 
+	long int lines, 
+	long int columns);
+
+/**
+ * \brief Saves a float matrix pointed by data on a specified filename
+ * 
+ * The data is saved as a float type - not as chars
+ * 
+ * \return 0 on success
+ * */
+int save_float_matrix(const float *matrix, 
+	long int number_of_lines, 
+	long int number_of_columns,
+	const char *filename );
+
+/**
+ * \brief Loads a float matrix saved by save_float_matrix()
+ * 
+ * \return A pointer on success, NULL on an error 
+*/ 
+float* load_float_matrix(const char *filename,
+	long int number_of_lines,
+	long int number_of_columns
+	);
+
 /**
 	\brief Compares 2 matrixes stored on main memory
 
@@ -267,6 +315,735 @@ int compare_double_matrixes_on_files(const char *filename1,
 	long int number_of_columns);
 
 
+/**
+ * \brief General matrix multiplication: C = alpha * A * B + beta * C
+ * 
+ * All matrixes are row-major (see the M() macro), A is m x k, B is k x n and
+ * C is m x n. The leading dimensions (lda, ldb, ldc) are the distance, in
+ * elements, between two consecutive lines, so sub-matrixes can be used.
+ * When beta is zero C does not need to be initialized.
+ * 
+ * The multiplication is cache blocked, with a SIMD micro-kernel picked at
+ * startup (see ppc_gemm_kernel_name()), and runs with all OpenMP threads.
+ * Called from inside a parallel region it runs on the calling thread only.
+ * */
+void ppc_dgemm(long int m, long int n, long int k,
+	double alpha,
+	const double *a, long int lda,
+	const double *b, long int ldb,
+	double beta,
+	double *c, long int ldc);
+
+/**
+ * \brief Single precision matrix multiplication: C = alpha * A * B + beta * C
+ * 
+ * Same as ppc_dgemm() on float matrixes. The SIMD micro-kernels hold twice
+ * as many floats per register, so it does about twice the FLOP/s, and
+ * moves half the bytes.
+ * */
+void ppc_sgemm(long int m, long int n, long int k,
+	float alpha,
+	const float *a, long int lda,
+	const float *b, long int ldb,
+	float beta,
+	float *c, long int ldc);
+
+/**
+ * \brief Mixed precision matrix multiplication: C = alpha * A * B + beta * C
+ * 
+ * A and B are float, C is double. The float values are converted to double
+ * while packed and the products are accumulated in double, with the
+ * ppc_dgemm() micro-kernels: inputs take half the memory, without the
+ * rounding of float accumulation.
+ * */
+void ppc_dsgemm(long int m, long int n, long int k,
+	double alpha,
+	const float *a, long int lda,
+	const float *b, long int ldb,
+	double beta,
+	double *c, long int ldc);
+
+/**
+ * \brief Batched matrix multiplication: C[i] = alpha * A[i] * B[i] + beta * C[i]
+ * 
+ * Every product of the batch has the same dimensions and leading dimensions
+ * (as in ppc_dgemm()). The batch is split across the OpenMP threads and each
+ * product runs entirely on one thread, which is what pays off for many small
+ * (32x32 to 256x256) matrixes.
+ * 
+ * \param batch_count number of products
+ * \param a_array array with batch_count pointers to the A matrixes
+ * \param b_array array with batch_count pointers to the B matrixes
+ * \param c_array array with batch_count pointers to the C matrixes
+ * */
+void ppc_dgemm_batch(long int batch_count,
+	long int m, long int n, long int k,
+	double alpha,
+	const double *const *a_array, long int lda,
+	const double *const *b_array, long int ldb,
+	double beta,
+	double *const *c_array, long int ldc);
+
+/**
+ * \brief Name of the GEMM micro-kernel chosen for this CPU
+ * 
+ * One of "avx512", "avx2", "sse2" or "scalar". The environment variable
+ * PPC_GEMM_KERNEL forces a kernel, if the CPU supports it.
+ * */
+const char *ppc_gemm_kernel_name(void);
+
+/**
+ * \brief Number of lines of A/C each thread takes at a time in ppc_dgemm()
+ * 
+ * ppc_dgemm() splits the lines of A and C in blocks of this size with a
+ * static schedule. Use it as block_lines in the *_first_touch functions so
+ * each page is placed on the node of the thread that computes it.
+ * */
+long int ppc_gemm_row_block(void);
+
+/**
+ * \brief Current cache blocking of ppc_dgemm() (see ppc_gemm_set_blocking())
+ * */
+void ppc_gemm_get_blocking(long int *mc, long int *kc, long int *nc);
+
+/**
+ * \brief Changes the cache blocking of ppc_dgemm()
+ * 
+ * mc lines of A are packed per thread (L2), kc is the depth of each packed
+ * panel (L1) and nc the number of columns of B packed at a time (L3).
+ * mc and nc are rounded up to multiples of the micro-kernel block; values
+ * <= 0 keep the current setting. Must not be called while a ppc_dgemm() is
+ * running.
+ * */
+void ppc_gemm_set_blocking(long int mc, long int kc, long int nc);
+
+/**
+ * \brief Allocates a zeroed double matrix whose pages are first touched in parallel
+ * 
+ * Lines are grouped in blocks of block_lines and the blocks are touched by
+ * the OpenMP threads with schedule(static), so on NUMA machines each page is
+ * placed on the node of the thread that will compute it with the same
+ * partition. The memory is page aligned and MUST be freed with free().
+ * 
+ * \return A pointer on success, NULL on an error
+ * */
+double *alloc_double_matrix_first_touch(long int lines, long int columns, long int block_lines);
+
+/**
+ * \brief Loads a matrix saved on a file with parallel first touch
+ * 
+ * Same as load_double_matrix(), but every thread reads its own blocks of
+ * block_lines lines (see alloc_double_matrix_first_touch()).
+ * 
+ * \return A pointer on success, NULL on an error
+ * */
+double *load_double_matrix_first_touch(const char *filename,
+	long int number_of_lines,
+	long int number_of_columns,
+	long int block_lines);
+
+/**
+ * \brief Generates a random double matrix with parallel first touch
+ * 
+ * Generates the same values as generate_random_double_matrix(), in memory
+ * placed as in alloc_double_matrix_first_touch().
+ * */
+double *generate_random_double_matrix_first_touch(long int lines,
+	long int columns,
+	long int block_lines);
+
+/**
+ * \brief Pins each OpenMP thread to one CPU, spread over the NUMA nodes
+ * 
+ * Does nothing when OMP_PROC_BIND or OMP_PLACES is set (the OpenMP runtime
+ * binds the threads then, and OMP_PROC_BIND=false disables binding).
+ * Must be called before the first parallel region that matters, with the
+ * same number of threads.
+ * 
+ * \return 1 if the threads were pinned, 0 otherwise
+ * */
+int ppc_pin_threads(void);
+
+/**
+ * \brief Counts on which NUMA node each page of a memory region is
+ * 
+ * \param data start of the region
+ * \param bytes size of the region
+ * \param pages_per_node filled with the number of pages on each node
+ * \param max_nodes size of pages_per_node
+ * 
+ * \return number of nodes (highest node seen + 1), -1 if not supported
+ * */
+int numa_page_distribution(const void *data, size_t bytes, long int *pages_per_node, int max_nodes);
+
+/**
+ * \brief Name of the tuning profile file
+ * 
+ * The environment variable PPC_PROFILE, or "ppc_profile.txt" on the current
+ * directory when it is not set. Each line of the file is "<key> <size> <value>".
+ * */
+const char *ppc_profile_filename(void);
+
+/**
+ * \brief Looks up a tuned parameter on the profile file
+ * 
+ * Returns the value saved for key with the nearest problem size (on a log
+ * scale), or default_value when the key is not on the profile.
+ * 
+ * Example:
+ * long int cutoff = ppc_profile_get("quicksort_corte", n, 1000);
+ * */
+long int ppc_profile_get(const char *key, long int size, long int default_value);
+
+/**
+ * \brief Saves a tuned parameter for a problem size on the profile file
+ * 
+ * Replaces the entry with the same key and size, if there is one.
+ * 
+ * \return 0 on success
+ * */
+int ppc_profile_set(const char *key, long int size, long int value);
+
+/**
+ * \brief Best time of a few runs of a candidate configuration, for autotuning
+ * 
+ * Calls run(context) up to 20 times: once if it takes 2 s, otherwise at
+ * least 3 times and 0.5 s in total. setup(context), when not NULL, is called
+ * before each run and is not timed (to restore the input, for example).
+ * 
+ * \return the smallest time, in seconds
+ * */
+double ppc_profile_time(void (*setup)(void *), void (*run)(void *), void *context);
+
+/**
+ * \brief Times run(context) with 1, 2, 4, ... threads and the maximum
+ * 
+ * Each count is timed with ppc_profile_time() and printed. The number of
+ * threads is restored to the maximum at the end.
+ * 
+ * \param pin_threads when nonzero, ppc_pin_threads() is called after each
+ * change of the number of threads
+ * 
+ * \return the number of threads with the smallest time
+ * */
+int ppc_profile_tune_threads(void (*setup)(void *), void (*run)(void *), void *context, int pin_threads);
+
+/**
+ * \brief Sets the number of OpenMP threads saved on the profile for key
+ * 
+ * Does nothing when there is no entry for key or when OMP_NUM_THREADS is
+ * set, since a number of threads chosen by the user has precedence.
+ * */
+void ppc_profile_apply_threads(const char *key, long int size);
+
+/**
+	\brief A sparse matrix in CSR (compressed sparse row) format
+
+	The nonzeros of line i are values[row_ptr[i]] .. values[row_ptr[i + 1] - 1],
+	on the columns col_idx[row_ptr[i]] .. col_idx[row_ptr[i + 1] - 1], sorted.
+	The CSC form of a matrix is the CSR form of its transpose.
+*/
+typedef struct {
+
+	long int lines;
+	long int columns;
+	long int nnz;
+	long int *row_ptr;
+	long int *col_idx;
+	double *values;
+
+} ppc_csr_t;
+
+/**
+ * \brief Allocates a CSR matrix with room for nnz nonzeros
+ * 
+ * Only row_ptr[0] is initialized. Free it with free_csr_matrix().
+ * 
+ * \return A pointer on success, NULL on an error
+ * */
+ppc_csr_t *alloc_csr_matrix(long int lines, long int columns, long int nnz);
+
+/**
+ * \brief Frees a CSR matrix and its arrays
+ * */
+void free_csr_matrix(ppc_csr_t *csr);
+
+/**
+ * \brief Generates a random sparse matrix
+ * 
+ * About density x columns nonzeros per line, on random columns, with integer
+ * values between 1 and 10. The lines are generated in parallel and the
+ * matrix only depends on seed, not on the number of threads.
+ * */
+ppc_csr_t *generate_random_csr_matrix(long int lines, long int columns, double density, unsigned int seed);
+
+/**
+ * \brief Converts a dense (row-major) matrix to CSR, skipping the zeros
+ * */
+ppc_csr_t *dense_to_csr_matrix(const double *matrix, long int lines, long int columns);
+
+/**
+ * \brief Converts a CSR matrix to a dense (row-major) one
+ * 
+ * The programmer MUST free the allocated memory after its use!
+ * */
+double *csr_to_dense_matrix(const ppc_csr_t *csr);
+
+/**
+ * \brief Transposes a CSR matrix, which is also its conversion to CSC
+ * */
+ppc_csr_t *transpose_csr_matrix(const ppc_csr_t *csr);
+
+/**
+ * \brief Saves a CSR matrix on a file
+ * 
+ * The file holds lines, columns and nnz, then row_ptr, col_idx and values,
+ * in binary.
+ * 
+ * \return 0 on success
+ * */
+int save_csr_matrix(const ppc_csr_t *csr, const char *filename);
+
+/**
+ * \brief Loads a CSR matrix saved by save_csr_matrix()
+ * 
+ * \return A pointer on success, NULL on an error
+ * */
+ppc_csr_t *load_csr_matrix(const char *filename);
+
+/**
+ * \brief Sparse matrix-vector product: y = A * x
+ * 
+ * The lines are split across the OpenMP threads by nonzeros, not by count.
+ * */
+void ppc_csr_spmv(const ppc_csr_t *a, const double *x, double *y);
+
+/**
+ * \brief Sparse matrix-matrix product: C = A * B, all in CSR
+ * 
+ * The lines of C are split across the OpenMP threads by the number of
+ * multiply-adds each one takes; every thread builds its lines with a dense
+ * accumulator of B->columns values (symbolic pass, then numeric pass).
+ * 
+ * \return A new matrix on success, NULL if the sizes do not match or on an error
+ * */
+ppc_csr_t *ppc_csr_spgemm(const ppc_csr_t *a, const ppc_csr_t *b);
+
+/**
+ * \brief Reads a tile of a matrix saved on a file (see save_double_matrix())
+ * 
+ * Reads lines x columns elements, starting at (first_line, first_column),
+ * into tile, whose leading dimension is ld. The file position is not used,
+ * so several threads can read the same file at once.
+ * 
+ * \param fd file opened with fopen()
+ * \param number_of_columns number of columns of the whole matrix on the file
+ * 
+ * \return 0 on success
+ * */
+int read_double_matrix_tile(FILE *fd,
+	long int number_of_columns,
+	long int first_line, long int first_column,
+	long int lines, long int columns,
+	double *tile, long int ld);
+
+/**
+ * \brief Writes a tile of a matrix on a file, the inverse of read_double_matrix_tile()
+ * 
+ * \return 0 on success
+ * */
+int write_double_matrix_tile(FILE *fd,
+	long int number_of_columns,
+	long int first_line, long int first_column,
+	long int lines, long int columns,
+	const double *tile, long int ld);
+
+/**
+ * \brief Generates a random double matrix straight on a file
+ * 
+ * Same values and file as generate_random_double_matrix() followed by
+ * save_double_matrix(), but only one line is kept in memory.
+ * 
+ * \return 0 on success
+ * */
+int generate_random_double_matrix_file(long int lines, long int columns, const char *filename);
+
+/**
+ * \brief Out-of-place transposition: B = A^T
+ * 
+ * A has lines x columns elements (leading dimension lda) and B columns x
+ * lines (leading dimension ldb). Cache-oblivious: the blocks are halved
+ * recursively down to 32 x 32, with OpenMP tasks for the large halves.
+ * */
+void ppc_transpose(long int lines, long int columns,
+	const double *a, long int lda,
+	double *b, long int ldb);
+
+/**
+ * \brief In-place transposition of a square matrix of the given order
+ * 
+ * Diagonal blocks are transposed and the off-diagonal ones swapped
+ * recursively, in parallel, without extra memory.
+ * */
+void ppc_transpose_inplace(double *a, long int order, long int lda);
+
+/**
+ * \brief Converts a row-major matrix (see M()) to column-major (Fortran order)
+ * 
+ * a and b must not overlap.
+ * */
+void ppc_row_to_column_major(long int lines, long int columns, const double *a, double *b);
+
+/**
+ * \brief Converts a column-major matrix to row-major
+ * */
+void ppc_column_to_row_major(long int lines, long int columns, const double *a, double *b);
+
+/**
+ * \brief Converts a row-major matrix to the tiled layout
+ * 
+ * The tiled layout keeps each tile x tile block contiguous (and row-major
+ * inside), tile line by tile line. Tiles on the last line/column are
+ * smaller, without padding, so both layouts have lines x columns elements.
+ * */
+void ppc_row_major_to_tiled(long int lines, long int columns, long int tile, const double *a, double *tiled);
+
+/**
+ * \brief Converts a matrix in the tiled layout back to row-major
+ * */
+void ppc_tiled_to_row_major(long int lines, long int columns, long int tile, const double *tiled, double *a);
+
+/**
+ * \brief LU factorization with partial pivoting: P * A = L * U
+ * 
+ * A (lines x columns, row-major, leading dimension lda) is overwritten by
+ * L, unit lower triangular without its diagonal, and U, upper triangular.
+ * Line i was swapped with line ipiv[i] (0-based, in order i = 0, 1, ...),
+ * and ipiv must have min(lines, columns) elements.
+ * 
+ * Blocked right-looking algorithm: the panels are factored recursively and
+ * the trailing matrix is updated with ppc_dgemm(), with all OpenMP threads.
+ * 
+ * \return 0 on success, or i + 1 if U[i][i] is exactly zero (the matrix is
+ * singular; the factorization is still completed)
+ * */
+int ppc_dgetrf(long int lines, long int columns, double *a, long int lda, int *ipiv);
+
+/**
+ * \brief Tiled LU factorization with partial pivoting, as OpenMP tasks
+ * 
+ * Same result and arguments as ppc_dgetrf(). The matrix (still row-major)
+ * is split in tile x tile blocks and each panel factorization, line swap,
+ * triangular solve and GEMM on a tile is a task with depend clauses, so
+ * the next panel starts while the previous trailing update is running,
+ * without a barrier per step.
+ * 
+ * \return 0 on success, or i + 1 if U[i][i] is exactly zero
+ * */
+int ppc_dgetrf_tiled(long int lines, long int columns, double *a, long int lda, int *ipiv, long int tile);
+
+/**
+ * \brief Solves A * X = B with the factorization of ppc_dgetrf()
+ * 
+ * lu and ipiv are the output of ppc_dgetrf() (or ppc_dgetrf_tiled()) for
+ * the order x order matrix A. B has order lines and nrhs columns, one
+ * right-hand side per column (leading dimension ldb), and is overwritten by X.
+ * 
+ * The substitutions are blocked: each block of lines is solved with the
+ * diagonal block of L or U and the remaining lines are updated with a
+ * matrix product, so many right-hand sides run at about ppc_dgemm() speed.
+ * */
+void ppc_dgetrs(long int order, long int nrhs, const double *lu, long int lda, const int *ipiv,
+	double *b, long int ldb);
+
+/**
+ * \brief Single precision LU factorization with partial pivoting
+ * 
+ * Same as ppc_dgetrf() on a float matrix, with ppc_sgemm() for the updates.
+ * */
+int ppc_sgetrf(long int lines, long int columns, float *a, long int lda, int *ipiv);
+
+/**
+ * \brief Solves A * X = B with the factorization of ppc_sgetrf()
+ * 
+ * Same as ppc_dgetrs() on float matrixes.
+ * */
+void ppc_sgetrs(long int order, long int nrhs, const float *lu, long int lda, const int *ipiv,
+	float *b, long int ldb);
+
+/**
+ * \brief Applies the line swaps of ppc_sgetrf() to a float matrix (see ppc_dlaswp())
+ * */
+void ppc_slaswp(long int columns, float *a, long int lda, long int k1, long int k2, const int *ipiv);
+
+/**
+ * \brief Mixed precision solver of A * X = B with iterative refinement
+ * 
+ * A is factored in float (ppc_sgetrf()) and the solution is refined in
+ * double: x += (LU)^-1 (b - A x), with the residual computed in double,
+ * until ||b - A x||_inf <= ||x||_inf ||A||_inf eps sqrt(order) on every
+ * column (the LAPACK dsgesv test), so X is as accurate as a double solve.
+ * If the float factorization fails or the refinement does not converge in
+ * 30 iterations, the system is solved with ppc_dgetrf()/ppc_dgetrs().
+ * 
+ * A and B are not modified; X (order x nrhs, leading dimension ldx) gets
+ * the solution.
+ * 
+ * \param iterations set to the number of refinement iterations, or -1 if
+ * the double precision solver was used
+ * 
+ * \return 0 on success, or i + 1 if A is singular (U[i][i] is zero)
+ * */
+int ppc_dsgesv(long int order, long int nrhs, const double *a, long int lda,
+	const double *b, long int ldb, double *x, long int ldx, int *iterations);
+
+/**
+ * \brief Cholesky factorization of a symmetric positive definite matrix: A = L * L^T
+ * 
+ * Only the lower triangle of A (order x order, leading dimension lda) is
+ * read, and it is overwritten by L; the upper triangle is not touched.
+ * Blocked, with the trailing updates done by ppc_dgemm() in parallel:
+ * about half the operations of ppc_dgetrf(), without pivoting.
+ * 
+ * \return 0 on success, or i + 1 if the leading minor of order i + 1 is not
+ * positive definite (A is not SPD; the factorization stops there)
+ * */
+int ppc_dpotrf(long int order, double *a, long int lda);
+
+/**
+ * \brief Applies the line swaps ipiv[k1] .. ipiv[k2 - 1] of ppc_dgetrf() to a matrix
+ * 
+ * For i = k1 .. k2 - 1, swaps the lines i and ipiv[i] of the columns first
+ * columns of a.
+ * */
+void ppc_dlaswp(long int columns, double *a, long int lda, long int k1, long int k2, const int *ipiv);
+
+/**
+	\brief A square band matrix, with kl diagonals below and ku above the main one
+
+	Line i is values[i * ld] .. values[i * ld + ld - 1] and holds the columns
+	i - kl .. i + kl + ku (see the BAND() macro), ld = 2 * kl + ku + 1: the
+	kl extra upper diagonals are the fill-in of ppc_band_getrf(). Memory is
+	order * ld doubles, instead of order * order.
+*/
+typedef struct {
+
+	long int order;
+	long int kl;
+	long int ku;
+	long int ld;
+	double *values;
+
+} ppc_band_t;
+
+/**
+ * \brief Element (i, j) of a band matrix, for i - kl <= j <= i + kl + ku
+ * */
+#define BAND(band, i, j) (band)->values[ (i) * (band)->ld + (j) - (i) + (band)->kl ]
+
+/**
+ * \brief Allocates a band matrix, with all its elements zeroed
+ * 
+ * Free it with free_band_matrix().
+ * 
+ * \return A pointer on success, NULL on an error
+ * */
+ppc_band_t *alloc_band_matrix(long int order, long int kl, long int ku);
+
+/**
+ * \brief Frees a band matrix and its values
+ * */
+void free_band_matrix(ppc_band_t *band);
+
+/**
+ * \brief Generates a random, diagonally dominant, band matrix
+ * 
+ * Integer values between 1 and 10 off the diagonal, and the diagonal one
+ * more than the sum of the rest of its line, so it can be factored without
+ * pivoting. The lines are generated in parallel and the matrix only
+ * depends on seed, not on the number of threads.
+ * */
+ppc_band_t *generate_random_band_matrix(long int order, long int kl, long int ku, unsigned int seed);
+
+/**
+ * \brief Converts a dense (row-major) matrix to a band one, dropping what is out of the band
+ * */
+ppc_band_t *dense_to_band_matrix(const double *matrix, long int order, long int kl, long int ku);
+
+/**
+ * \brief Converts a band matrix to a dense (row-major) one, fill-in diagonals included
+ * 
+ * The programmer MUST free the allocated memory after its use!
+ * */
+double *band_to_dense_matrix(const ppc_band_t *band);
+
+/**
+ * \brief Saves a band matrix on a file
+ * 
+ * The file holds order, kl and ku, then the values, in binary.
+ * 
+ * \return 0 on success
+ * */
+int save_band_matrix(const ppc_band_t *band, const char *filename);
+
+/**
+ * \brief Loads a band matrix saved by save_band_matrix()
+ * 
+ * \return A pointer on success, NULL on an error
+ * */
+ppc_band_t *load_band_matrix(const char *filename);
+
+/**
+ * \brief Band matrix-vector product: y = A * x
+ * 
+ * Only valid before ppc_band_getrf(), which overwrites the matrix.
+ * */
+void ppc_band_gbmv(const ppc_band_t *band, const double *x, double *y);
+
+/**
+ * \brief LU factorization with partial pivoting of a band matrix
+ * 
+ * The pivot of column k is searched on the lines k .. k + kl only, so the
+ * band is kept: U gets kl + ku upper diagonals and the multipliers of L
+ * stay on the kl lower ones (as LAPACK dgbtrf). O(order * kl * (kl + ku))
+ * operations; the lines of a step are updated in parallel when the band is
+ * wide enough to pay for it.
+ * 
+ * \param ipiv order pivots, 0-based: line k was swapped with line ipiv[k]
+ * 
+ * \return 0 on success, or i + 1 if U[i][i] is exactly zero
+ * */
+int ppc_band_getrf(ppc_band_t *band, int *ipiv);
+
+/**
+ * \brief Solves A * x = b with the factorization of ppc_band_getrf()
+ * 
+ * b (order values) is overwritten by x.
+ * */
+void ppc_band_getrs(const ppc_band_t *band, const int *ipiv, double *b);
+
+/**
+ * \brief Solves a tridiagonal system in parallel
+ * 
+ * sub[i], diagonal[i] and super[i] are the elements (i, i - 1), (i, i) and
+ * (i, i + 1) of line i (sub[0] and super[order - 1] are not read). The
+ * lines are split in one block per thread, each block is eliminated on its
+ * own, and the unknowns on the borders of the blocks are found by a small
+ * band system before each thread finishes its block: O(order) work, about
+ * twice the serial Thomas algorithm, done in parallel. There is no
+ * pivoting, so the matrix must be diagonally dominant (or SPD).
+ * 
+ * rhs (order values) is overwritten by the solution.
+ * 
+ * \return 0 on success, or i + 1 if a zero pivot was found on line i
+ * */
+int ppc_tridiagonal_solve(long int order, const double *sub, const double *diagonal, const double *super,
+	double *rhs);
+
+/**
+ * \brief Householder QR factorization: A = Q * R
+ * 
+ * A is lines x columns (row-major, leading dimension lda). On return R is
+ * on and above the diagonal, and the Householder vectors of Q = H1 H2 ...
+ * below it (each with an implicit 1 on the diagonal), with their scalars in
+ * tau (min(lines, columns) values), as LAPACK dgeqrf. Blocked: each panel
+ * of 32 columns is applied to the rest of the matrix in the compact WY form
+ * I - V T V^T, with ppc_dgemm(), in parallel.
+ * 
+ * \return 0 on success, -1 if there is no memory
+ * */
+int ppc_dgeqrf(long int lines, long int columns, double *a, long int lda, double *tau);
+
+/**
+ * \brief Computes Q^T * B with the factorization of ppc_dgeqrf()
+ * 
+ * B is lines x nrhs (leading dimension ldb) and is overwritten.
+ * */
+void ppc_dormqr(long int lines, long int columns, long int nrhs, const double *qr, long int lda,
+	const double *tau, double *b, long int ldb);
+
+/**
+ * \brief Least-squares solution of min ||A * X - B||_2, for lines >= columns
+ * 
+ * A (lines x columns) is overwritten by its QR factorization (ppc_dgeqrf()),
+ * and B (lines x nrhs) by Q^T B: its first columns lines are the solution
+ * X, and the norm of the rest of each column is the norm of its residual.
+ * 
+ * \return 0 on success, i + 1 if R[i][i] is zero (A does not have full
+ * rank), or -1 if lines < columns or there is no memory
+ * */
+int ppc_dgels(long int lines, long int columns, long int nrhs, double *a, long int lda, double *b, long int ldb);
+
+/**
+ * \brief R factor of a tall-skinny matrix by TSQR (tall-skinny QR)
+ * 
+ * The lines of A are split in blocks that fit in L2, every block is
+ * factored by ppc_dgeqrf() in parallel, and their R factors are combined
+ * pairwise, in a binary tree, by the QR of the two stacked R. Q is not
+ * formed: to solve min ||A x - b||, factor [A b], and R x = the first
+ * columns values of its last column.
+ * 
+ * A is used as workspace (overwritten); r (columns x columns, leading
+ * dimension ldr) gets R, with zeros below the diagonal. R is the R of
+ * ppc_dgeqrf() up to the signs of its lines.
+ * 
+ * \return 0 on success, -1 if lines < columns or there is no memory
+ * */
+int ppc_dtsqr(long int lines, long int columns, double *a, long int lda, double *r, long int ldr);
+
+/**
+ * \brief Determinant of a square matrix (order x order, leading dimension lda)
+ * 
+ * The product of the pivots of its LU factorization (ppc_dgetrf()). The
+ * factorization is kept in a small in-memory cache keyed by the matrix, so
+ * ppc_log_determinant(), ppc_inverse() and ppc_condition_estimate() on the
+ * same matrix do not factor it again. Overflows to +-inf for large
+ * matrixes: use ppc_log_determinant().
+ * */
+double ppc_determinant(long int order, const double *a, long int lda);
+
+/**
+ * \brief Logarithm of the absolute value of the determinant, and its sign
+ * 
+ * det(A) = sign * exp(log-det), without overflow or underflow.
+ * 
+ * \param sign set to 1 or -1, or to 0 if A is singular (and -inf is returned)
+ * */
+double ppc_log_determinant(long int order, const double *a, long int lda, int *sign);
+
+/**
+ * \brief Inverse of a square matrix
+ * 
+ * Solves A X = I with the cached LU factorization (see ppc_determinant()),
+ * each OpenMP thread on its own blocks of 64 columns of X.
+ * 
+ * \return 0 on success, i + 1 if A is singular (U[i][i] is zero), or -1 if
+ * there is no memory
+ * */
+int ppc_inverse(long int order, const double *a, long int lda, double *inverse, long int ldi);
+
+/**
+ * \brief Estimate of the 1-norm condition number ||A||_1 ||A^-1||_1
+ * 
+ * ||A^-1||_1 is estimated from a few solves with the cached LU factorization
+ * (Hager and Higham, as LAPACK dlacn2), O(order^2) operations instead of
+ * the O(order^3) of the inverse. The estimate is a lower bound, usually
+ * within a factor of 3 of the true value.
+ * 
+ * \return the estimate, or inf if A is singular
+ * */
+double ppc_condition_estimate(long int order, const double *a, long int lda);
+
+/**
+ * \brief Frees the factorizations cached by ppc_determinant() and friends
+ * */
+void ppc_lu_cache_clear(void);
+
+/**
+ * \brief Number of lookups of the LU cache that found the factorization (hits) or not (misses)
+ * */
+void ppc_lu_cache_stats(long int *hits, long int *misses);
+
 #if 0
 /*
 	\brief save current matrix on the file filename
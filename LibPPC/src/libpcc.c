@@ -522,6 +522,38 @@ double *generate_random_double_matrix(
 	return ((double *)matrix);
 }
 
+double *generate_random_spd_matrix(long int order)
+{
+	double *matrix = (double *)malloc(sizeof(double) * order * order);
+
+	for (long int i = 0; i < order; i++)
+	{
+		for (long int j = 0; j < i; j++)
+		{
+			double x = rand() % order;
+
+			matrix[i * order + j] = x;
+			matrix[j * order + i] = x;
+		}
+	}
+
+	for (long int i = 0; i < order; i++)
+	{
+		double sum = 1.0;
+
+		for (long int j = 0; j < order; j++)
+		{
+			// Off-diagonal values are not negative
+			if (j != i)
+				sum += matrix[i * order + j];
+		}
+
+		matrix[i * order + i] = sum;
+	}
+
+	return ((double *)matrix);
+}
+
 int compare_double_matrixes(const double **matrix1,
 							const double **matrix2,
 							long int lines,
@@ -607,6 +639,87 @@ double *load_double_matrix(const char *filename,
 	}
 }
 
+float *generate_random_float_matrix(
+	long int lines,
+	long int columns)
+{
+	float *matrix = (float *)malloc(sizeof(float) * lines * columns);
+
+	for (long int i = 0; i < lines; i++)
+	{
+
+		for (long int j = 0; j < columns; j++)
+		{
+
+			float x = rand() % (lines * columns);
+
+			matrix[i * columns + j] = x;
+		}
+	}
+
+	return matrix;
+}
+
+int save_float_matrix(const float *matrix,
+					  long int number_of_lines,
+					  long int number_of_columns,
+					  const char *filename)
+{
+
+	FILE *fd = fopen(filename, "wb");
+
+	if (fd == NULL)
+	{
+		perror("Error: could not create the matrix file");
+		return -1;
+	}
+
+	size_t size = number_of_columns * number_of_lines;
+
+	size_t nelements = fwrite(matrix, sizeof(float), size, fd);
+
+	fclose(fd);
+
+	if (nelements != size)
+	{
+		perror("Error: size saved is not the size of the matrix");
+		return -1;
+	}
+
+	return 0;
+}
+
+float *load_float_matrix(const char *filename,
+						 long int number_of_lines,
+						 long int number_of_columns)
+{
+
+	FILE *fd = fopen(filename, "rb");
+
+	if (fd == NULL)
+	{
+		perror("Error: could not open the matrix file");
+		return NULL;
+	}
+
+	size_t size = number_of_lines * number_of_columns;
+
+	float *matrix = (float *)malloc(size * sizeof(float));
+
+	size_t nelements = fread(matrix, sizeof(float), size, fd);
+
+	fclose(fd);
+
+	if (nelements != size)
+	{
+		fprintf(stderr, "Error: matrix size saved on file is not the requested by the function\n");
+		free(matrix);
+		return NULL;
+	}
+
+	return matrix;
+}
+
 int compare_double_matrixes_on_files(const char *matrix_file1,
 									 const char *matrix_file2,
 									 long int number_of_lines,
@@ -0,0 +1,449 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <omp.h>
+
+#include <libppc.h>
+
+/*
+ * Band matrixes: line i keeps the columns i - kl .. i + kl + ku, so the
+ * factorization with partial pivoting fits in place (swapping a line up to
+ * kl lines below widens U to kl + ku upper diagonals, as in LAPACK dgbtrf).
+ * Storage and work are O(order * bandwidth) and O(order * bandwidth^2).
+ */
+
+// Multiply-adds per elimination step from which the lines of a step are
+// updated in parallel (below it the fork costs more than the step)
+#define BAND_PARALLEL_WORK 32768
+
+// Smallest block of lines per thread in the tridiagonal solver
+#define TRIDIAGONAL_MIN_BLOCK 1024
+
+ppc_band_t *alloc_band_matrix(long int order, long int kl, long int ku)
+{
+	ppc_band_t *band = (ppc_band_t *)malloc(sizeof(ppc_band_t));
+
+	if (band == NULL)
+		return NULL;
+
+	band->order = order;
+	band->kl = kl;
+	band->ku = ku;
+	band->ld = 2 * kl + ku + 1;
+	band->values = (double *)calloc(order * band->ld > 0 ? order * band->ld : 1, sizeof(double));
+
+	if (band->values == NULL)
+	{
+		free(band);
+		return NULL;
+	}
+
+	return band;
+}
+
+void free_band_matrix(ppc_band_t *band)
+{
+	if (band == NULL)
+		return;
+
+	free(band->values);
+	free(band);
+}
+
+ppc_band_t *generate_random_band_matrix(long int order, long int kl, long int ku, unsigned int seed)
+{
+	ppc_band_t *band = alloc_band_matrix(order, kl, ku);
+
+	if (band == NULL)
+		return NULL;
+
+	#pragma omp parallel for schedule(static)
+	for (long int i = 0; i < order; i++)
+	{
+		unsigned int state = seed ^ (unsigned int)(i * 2654435761u);
+		long int first = (i - kl > 0) ? i - kl : 0;
+		long int last = (i + ku < order - 1) ? i + ku : order - 1;
+		double sum = 1.0;
+
+		for (long int j = first; j <= last; j++)
+		{
+			if (j == i)
+				continue;
+
+			BAND(band, i, j) = 1 + rand_r(&state) % 10;
+			sum += BAND(band, i, j);
+		}
+
+		BAND(band, i, i) = sum;
+	}
+
+	return band;
+}
+
+ppc_band_t *dense_to_band_matrix(const double *matrix, long int order, long int kl, long int ku)
+{
+	ppc_band_t *band = alloc_band_matrix(order, kl, ku);
+
+	if (band == NULL)
+		return NULL;
+
+	for (long int i = 0; i < order; i++)
+		for (long int j = (i - kl > 0) ? i - kl : 0; j <= i + ku && j < order; j++)
+			BAND(band, i, j) = M(i, j, order, matrix);
+
+	return band;
+}
+
+double *band_to_dense_matrix(const ppc_band_t *band)
+{
+	long int order = band->order;
+	double *matrix = (double *)calloc(order * order, sizeof(double));
+
+	for (long int i = 0; i < order; i++)
+		for (long int j = (i - band->kl > 0) ? i - band->kl : 0; j <= i + band->kl + band->ku && j < order; j++)
+			M(i, j, order, matrix) = BAND(band, i, j);
+
+	return matrix;
+}
+
+int save_band_matrix(const ppc_band_t *band, const char *filename)
+{
+	FILE *fd = fopen(filename, "wb");
+
+	if (fd == NULL)
+	{
+		perror("Error: could not create the band matrix file");
+		return -1;
+	}
+
+	long int header[3] = {band->order, band->kl, band->ku};
+	int error = 0;
+
+	error |= fwrite(header, sizeof(long int), 3, fd) != 3;
+	error |= fwrite(band->values, sizeof(double), band->order * band->ld, fd) != (size_t)(band->order * band->ld);
+
+	fclose(fd);
+
+	if (error)
+	{
+		fprintf(stderr, "Error: could not write the band matrix file\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+ppc_band_t *load_band_matrix(const char *filename)
+{
+	FILE *fd = fopen(filename, "rb");
+
+	if (fd == NULL)
+	{
+		perror("Error: could not open the band matrix file");
+		return NULL;
+	}
+
+	long int header[3];
+
+	if (fread(header, sizeof(long int), 3, fd) != 3 || header[0] < 0 || header[1] < 0 || header[2] < 0)
+	{
+		fprintf(stderr, "Error: %s is not a band matrix file\n", filename);
+		fclose(fd);
+		return NULL;
+	}
+
+	ppc_band_t *band = alloc_band_matrix(header[0], header[1], header[2]);
+
+	if (band == NULL)
+	{
+		fclose(fd);
+		return NULL;
+	}
+
+	if (fread(band->values, sizeof(double), band->order * band->ld, fd) != (size_t)(band->order * band->ld))
+	{
+		fprintf(stderr, "Error: band matrix file %s is truncated\n", filename);
+		fclose(fd);
+		free_band_matrix(band);
+		return NULL;
+	}
+
+	fclose(fd);
+
+	return band;
+}
+
+void ppc_band_gbmv(const ppc_band_t *band, const double *x, double *y)
+{
+	long int order = band->order;
+
+	#pragma omp parallel for schedule(static)
+	for (long int i = 0; i < order; i++)
+	{
+		long int first = (i - band->kl > 0) ? i - band->kl : 0;
+		long int last = (i + band->ku < order - 1) ? i + band->ku : order - 1;
+		double sum = 0.0;
+
+		for (long int j = first; j <= last; j++)
+			sum += BAND(band, i, j) * x[j];
+
+		y[i] = sum;
+	}
+}
+
+/*
+ * line[j] is the column k + j of a line below the pivot: its multiplier is
+ * kept in line[0] and the pivot line is subtracted from the rest
+ */
+static inline void eliminate_line(double *line, const double *pivot_line, double inverse, long int width)
+{
+	double factor = line[0] * inverse;
+
+	line[0] = factor;
+	#pragma omp simd
+	for (long int j = 1; j <= width; j++)
+		line[j] -= factor * pivot_line[j];
+}
+
+int ppc_band_getrf(ppc_band_t *band, int *ipiv)
+{
+	long int order = band->order, kl = band->kl, ku = band->ku;
+	int parallel = kl * (kl + ku) >= BAND_PARALLEL_WORK;
+	int info = 0;
+
+	for (long int k = 0; k < order; k++)
+	{
+		long int last_line = (k + kl < order - 1) ? k + kl : order - 1;
+		long int last_column = (k + kl + ku < order - 1) ? k + kl + ku : order - 1;
+		long int p = k;
+		double largest = fabs(BAND(band, k, k));
+
+		for (long int i = k + 1; i <= last_line; i++)
+			if (fabs(BAND(band, i, k)) > largest)
+			{
+				largest = fabs(BAND(band, i, k));
+				p = i;
+			}
+
+		ipiv[k] = p;
+
+		if (largest == 0.0)
+		{
+			if (info == 0)
+				info = k + 1;
+			continue;
+		}
+
+		// Only the columns from k on move: the multipliers of the previous
+		// columns stay where they were computed (LAPACK band convention)
+		double *pivot_line = &BAND(band, k, k);
+		long int width = last_column - k;
+
+		if (p != k)
+		{
+			double *line = &BAND(band, p, k);
+
+			for (long int j = 0; j <= width; j++)
+			{
+				double value = pivot_line[j];
+				pivot_line[j] = line[j];
+				line[j] = value;
+			}
+		}
+
+		double inverse = 1.0 / pivot_line[0];
+
+		// A parallel region, even one made serial by its if clause, costs
+		// more than a whole step of a narrow band
+		if (parallel && !omp_in_parallel())
+		{
+			#pragma omp parallel for schedule(static)
+			for (long int i = k + 1; i <= last_line; i++)
+				eliminate_line(&BAND(band, i, k), pivot_line, inverse, width);
+		}
+		else
+		{
+			for (long int i = k + 1; i <= last_line; i++)
+				eliminate_line(&BAND(band, i, k), pivot_line, inverse, width);
+		}
+	}
+
+	return info;
+}
+
+void ppc_band_getrs(const ppc_band_t *band, const int *ipiv, double *b)
+{
+	long int order = band->order, kl = band->kl, ku = band->ku;
+
+	// L * y = P * b, with the swaps applied as the columns are eliminated
+	for (long int k = 0; k < order; k++)
+	{
+		long int last_line = (k + kl < order - 1) ? k + kl : order - 1;
+
+		if (ipiv[k] != k)
+		{
+			double value = b[k];
+			b[k] = b[ipiv[k]];
+			b[ipiv[k]] = value;
+		}
+
+		for (long int i = k + 1; i <= last_line; i++)
+			b[i] -= BAND(band, i, k) * b[k];
+	}
+
+	// U * x = y, U with kl + ku upper diagonals
+	for (long int i = order - 1; i >= 0; i--)
+	{
+		long int width = (i + kl + ku < order - 1) ? kl + ku : order - 1 - i;
+		const double *line = &BAND(band, i, i);
+		double sum = 0.0;
+
+		#pragma omp simd reduction(+ : sum)
+		for (long int j = 1; j <= width; j++)
+			sum += line[j] * b[i + j];
+
+		b[i] = (b[i] - sum) / line[0];
+	}
+}
+
+/*
+ * Partitioned tridiagonal solver. The lines are split in one block per
+ * thread, and each block [s, e] is eliminated independently (Thomas
+ * algorithm down, then up), leaving every unknown of the block as
+ *     x[i] = d[i] - left[i] * x[s - 1] - right[i] * x[e + 1]
+ * The first and last lines of the blocks give a reduced system on the 2P
+ * unknowns at the block borders, a band matrix with 2 lower and 2 upper
+ * diagonals solved by ppc_band_getrf(). Then each thread gets its interior
+ * unknowns from the formula above. O(n) work, two parallel passes.
+ */
+int ppc_tridiagonal_solve(long int order, const double *sub, const double *diagonal, const double *super,
+						  double *rhs)
+{
+	if (order <= 0)
+		return 0;
+
+	long int blocks = omp_get_max_threads();
+
+	if (blocks > order / TRIDIAGONAL_MIN_BLOCK)
+		blocks = order / TRIDIAGONAL_MIN_BLOCK;
+	if (blocks < 1)
+		blocks = 1;
+
+	// c' of the downward pass, then the left and right coefficients
+	double *upper = (double *)malloc(sizeof(double) * order);
+	double *left = (double *)malloc(sizeof(double) * order);
+	double *right = (double *)malloc(sizeof(double) * order);
+	int info = 0;
+
+	#pragma omp parallel for schedule(static, 1) num_threads(blocks) reduction(max : info)
+	for (long int p = 0; p < blocks; p++)
+	{
+		long int s = p * order / blocks;
+		long int e = (p + 1) * order / blocks - 1;
+		int singular = 0;
+
+		// Down: x[i] + upper[i] x[i + 1] + left[i] x[s - 1] = rhs[i]
+		for (long int i = s; i <= e; i++)
+		{
+			double a = (i > 0) ? sub[i] : 0.0;
+			double c = (i < order - 1) ? super[i] : 0.0;
+			double denominator = diagonal[i] - ((i > s) ? a * upper[i - 1] : 0.0);
+
+			if (denominator == 0.0)
+			{
+				singular = i + 1;
+				break;
+			}
+
+			upper[i] = c / denominator;
+			if (i == s)
+			{
+				left[i] = a / denominator;
+				rhs[i] = rhs[i] / denominator;
+			}
+			else
+			{
+				left[i] = -a * left[i - 1] / denominator;
+				rhs[i] = (rhs[i] - a * rhs[i - 1]) / denominator;
+			}
+		}
+
+		if (singular)
+		{
+			info = (singular > info) ? singular : info;
+			continue;
+		}
+
+		// Up: x[i] + left[i] x[s - 1] + right[i] x[e + 1] = rhs[i]
+		right[e] = upper[e];
+		for (long int i = e - 1; i >= s; i--)
+		{
+			rhs[i] -= upper[i] * rhs[i + 1];
+			left[i] -= upper[i] * left[i + 1];
+			right[i] = -upper[i] * right[i + 1];
+		}
+	}
+
+	if (info != 0 || blocks == 1)
+	{
+		free(upper);
+		free(left);
+		free(right);
+		return info;
+	}
+
+	// Reduced system: unknown 2p is x[s_p], 2p + 1 is x[e_p]
+	ppc_band_t *reduced = alloc_band_matrix(2 * blocks, 2, 2);
+	double *border = (double *)malloc(sizeof(double) * 2 * blocks);
+	int *ipiv = (int *)malloc(sizeof(int) * 2 * blocks);
+
+	for (long int p = 0; p < blocks; p++)
+	{
+		long int s = p * order / blocks;
+		long int e = (p + 1) * order / blocks - 1;
+
+		BAND(reduced, 2 * p, 2 * p) = 1.0;
+		BAND(reduced, 2 * p + 1, 2 * p + 1) = 1.0;
+		if (p > 0)
+		{
+			BAND(reduced, 2 * p, 2 * p - 1) = left[s];
+			BAND(reduced, 2 * p + 1, 2 * p - 1) = left[e];
+		}
+		if (p < blocks - 1)
+		{
+			BAND(reduced, 2 * p, 2 * p + 2) = right[s];
+			BAND(reduced, 2 * p + 1, 2 * p + 2) = right[e];
+		}
+		border[2 * p] = rhs[s];
+		border[2 * p + 1] = rhs[e];
+	}
+
+	info = ppc_band_getrf(reduced, ipiv);
+
+	if (info == 0)
+	{
+		ppc_band_getrs(reduced, ipiv, border);
+
+		#pragma omp parallel for schedule(static, 1) num_threads(blocks)
+		for (long int p = 0; p < blocks; p++)
+		{
+			long int s = p * order / blocks;
+			long int e = (p + 1) * order / blocks - 1;
+			double before = (p > 0) ? border[2 * p - 1] : 0.0;
+			double after = (p < blocks - 1) ? border[2 * p + 2] : 0.0;
+
+			for (long int i = s; i <= e; i++)
+				rhs[i] -= left[i] * before + right[i] * after;
+		}
+	}
+
+	free_band_matrix(reduced);
+	free(border);
+	free(ipiv);
+	free(upper);
+	free(left);
+	free(right);
+
+	return info;
+}
@@ -0,0 +1,677 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <omp.h>
+
+#include <libppc.h>
+
+/*
+ * Blocking of the GEMM engine: the micro-kernel keeps an MR x NR block of C
+ * in registers; KC is chosen so that a KC x NR micro-panel of B fits in L1,
+ * MC so that the packed MC x KC block of A fits in L2 and NC so that the
+ * packed KC x NC panel of B fits in L3.
+ * MR and NR depend on the micro-kernel picked at startup, so MC and NC are
+ * kept multiples of them. The defaults below can be changed (by the
+ * autotuner, for instance) with ppc_gemm_set_blocking().
+ */
+#define GEMM_MR_MAX 8
+#define GEMM_NR_MAX 16
+#define GEMM_MC 96
+#define GEMM_KC 256
+#define GEMM_NC 2048
+
+static long int gemm_mc = GEMM_MC;
+static long int gemm_kc = GEMM_KC;
+static long int gemm_nc = GEMM_NC;
+
+typedef void (*micro_kernel_t)(int kc, const double *a_pack, const double *b_pack,
+							   double *c, long int ldc, int mr, int nr,
+							   double alpha, double beta);
+
+typedef struct
+{
+	const char *name;
+	int mr;
+	int nr;
+	micro_kernel_t function;
+} gemm_kernel_t;
+
+static gemm_kernel_t gemm_kernel;
+
+/*
+ * Writes the mr_max x nr_max block computed in registers (stored in acc) to
+ * C as C = alpha * acc + beta * C. Used by the micro-kernels on the matrix
+ * borders, where the block of C is smaller than the register block.
+ * When beta is zero C is never read, so it may hold garbage.
+ */
+static void store_border_block(const double *acc, int nr_max, double *c, long int ldc,
+							   int mr, int nr, double alpha, double beta)
+{
+	for (int r = 0; r < mr; r++)
+	{
+		for (int s = 0; s < nr; s++)
+		{
+			if (beta == 0.0)
+				M(r, s, ldc, c) = alpha * acc[r * nr_max + s];
+			else
+				M(r, s, ldc, c) = alpha * acc[r * nr_max + s] + beta * M(r, s, ldc, c);
+		}
+	}
+}
+
+/*
+ * Portable 4x8 kernel, used when the CPU is not x86 or lacks SSE2.
+ */
+#define SCALAR_MR 4
+#define SCALAR_NR 8
+static void micro_kernel_scalar(int kc, const double *a_pack, const double *b_pack,
+								double *c, long int ldc, int mr, int nr,
+								double alpha, double beta)
+{
+	double acc[SCALAR_MR * SCALAR_NR] = {0.0};
+
+	for (int p = 0; p < kc; p++)
+	{
+		for (int r = 0; r < SCALAR_MR; r++)
+		{
+			double a_rp = a_pack[r];
+			for (int s = 0; s < SCALAR_NR; s++)
+			{
+				acc[r * SCALAR_NR + s] += a_rp * b_pack[s];
+			}
+		}
+		a_pack += SCALAR_MR;
+		b_pack += SCALAR_NR;
+	}
+
+	store_border_block(acc, SCALAR_NR, c, ldc, mr, nr, alpha, beta);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+/*
+ * SSE2 (every x86-64 has it): 4x4 block, 8 accumulators of 2 doubles.
+ * SSE2 has no FMA, so each step is a multiply followed by an add.
+ */
+#define SSE2_MR 4
+#define SSE2_NR 4
+__attribute__((target("sse2")))
+static void micro_kernel_sse2(int kc, const double *a_pack, const double *b_pack,
+							  double *c, long int ldc, int mr, int nr,
+							  double alpha, double beta)
+{
+	__m128d acc[SSE2_MR][SSE2_NR / 2];
+
+	for (int r = 0; r < SSE2_MR; r++)
+		for (int s = 0; s < SSE2_NR / 2; s++)
+			acc[r][s] = _mm_setzero_pd();
+
+	for (int p = 0; p < kc; p++)
+	{
+		__m128d b0 = _mm_loadu_pd(&b_pack[0]);
+		__m128d b1 = _mm_loadu_pd(&b_pack[2]);
+
+		for (int r = 0; r < SSE2_MR; r++)
+		{
+			__m128d a_rp = _mm_set1_pd(a_pack[r]);
+			acc[r][0] = _mm_add_pd(acc[r][0], _mm_mul_pd(a_rp, b0));
+			acc[r][1] = _mm_add_pd(acc[r][1], _mm_mul_pd(a_rp, b1));
+		}
+		a_pack += SSE2_MR;
+		b_pack += SSE2_NR;
+	}
+
+	if (mr == SSE2_MR && nr == SSE2_NR)
+	{
+		__m128d alpha_v = _mm_set1_pd(alpha);
+		__m128d beta_v = _mm_set1_pd(beta);
+
+		for (int r = 0; r < SSE2_MR; r++)
+		{
+			for (int s = 0; s < SSE2_NR / 2; s++)
+			{
+				double *c_rs = &M(r, 2 * s, ldc, c);
+				__m128d v = _mm_mul_pd(alpha_v, acc[r][s]);
+				if (beta != 0.0)
+					v = _mm_add_pd(v, _mm_mul_pd(beta_v, _mm_loadu_pd(c_rs)));
+				_mm_storeu_pd(c_rs, v);
+			}
+		}
+	}
+	else
+	{
+		double tmp[SSE2_MR * SSE2_NR];
+		for (int r = 0; r < SSE2_MR; r++)
+			for (int s = 0; s < SSE2_NR / 2; s++)
+				_mm_storeu_pd(&tmp[r * SSE2_NR + 2 * s], acc[r][s]);
+		store_border_block(tmp, SSE2_NR, c, ldc, mr, nr, alpha, beta);
+	}
+}
+
+/*
+ * AVX2 + FMA: 6x8 block, 12 accumulators of 4 doubles, 2 registers for the
+ * row of B and 1 for the broadcast of A (15 of the 16 ymm registers).
+ */
+#define AVX2_MR 6
+#define AVX2_NR 8
+__attribute__((target("avx2,fma")))
+static void micro_kernel_avx2(int kc, const double *a_pack, const double *b_pack,
+							  double *c, long int ldc, int mr, int nr,
+							  double alpha, double beta)
+{
+	__m256d acc[AVX2_MR][AVX2_NR / 4];
+
+	for (int r = 0; r < AVX2_MR; r++)
+		for (int s = 0; s < AVX2_NR / 4; s++)
+			acc[r][s] = _mm256_setzero_pd();
+
+	for (int p = 0; p < kc; p++)
+	{
+		__m256d b0 = _mm256_loadu_pd(&b_pack[0]);
+		__m256d b1 = _mm256_loadu_pd(&b_pack[4]);
+
+		for (int r = 0; r < AVX2_MR; r++)
+		{
+			__m256d a_rp = _mm256_broadcast_sd(&a_pack[r]);
+			acc[r][0] = _mm256_fmadd_pd(a_rp, b0, acc[r][0]);
+			acc[r][1] = _mm256_fmadd_pd(a_rp, b1, acc[r][1]);
+		}
+		a_pack += AVX2_MR;
+		b_pack += AVX2_NR;
+	}
+
+	if (mr == AVX2_MR && nr == AVX2_NR)
+	{
+		__m256d alpha_v = _mm256_set1_pd(alpha);
+		__m256d beta_v = _mm256_set1_pd(beta);
+
+		for (int r = 0; r < AVX2_MR; r++)
+		{
+			for (int s = 0; s < AVX2_NR / 4; s++)
+			{
+				double *c_rs = &M(r, 4 * s, ldc, c);
+				__m256d v = _mm256_mul_pd(alpha_v, acc[r][s]);
+				if (beta != 0.0)
+					v = _mm256_fmadd_pd(beta_v, _mm256_loadu_pd(c_rs), v);
+				_mm256_storeu_pd(c_rs, v);
+			}
+		}
+	}
+	else
+	{
+		double tmp[AVX2_MR * AVX2_NR];
+		for (int r = 0; r < AVX2_MR; r++)
+			for (int s = 0; s < AVX2_NR / 4; s++)
+				_mm256_storeu_pd(&tmp[r * AVX2_NR + 4 * s], acc[r][s]);
+		store_border_block(tmp, AVX2_NR, c, ldc, mr, nr, alpha, beta);
+	}
+}
+
+/*
+ * AVX-512: 8x16 block, 16 accumulators of 8 doubles (out of 32 zmm registers).
+ */
+#define AVX512_MR 8
+#define AVX512_NR 16
+__attribute__((target("avx512f")))
+static void micro_kernel_avx512(int kc, const double *a_pack, const double *b_pack,
+								double *c, long int ldc, int mr, int nr,
+								double alpha, double beta)
+{
+	__m512d acc[AVX512_MR][AVX512_NR / 8];
+
+	for (int r = 0; r < AVX512_MR; r++)
+		for (int s = 0; s < AVX512_NR / 8; s++)
+			acc[r][s] = _mm512_setzero_pd();
+
+	for (int p = 0; p < kc; p++)
+	{
+		__m512d b0 = _mm512_loadu_pd(&b_pack[0]);
+		__m512d b1 = _mm512_loadu_pd(&b_pack[8]);
+
+		for (int r = 0; r < AVX512_MR; r++)
+		{
+			__m512d a_rp = _mm512_set1_pd(a_pack[r]);
+			acc[r][0] = _mm512_fmadd_pd(a_rp, b0, acc[r][0]);
+			acc[r][1] = _mm512_fmadd_pd(a_rp, b1, acc[r][1]);
+		}
+		a_pack += AVX512_MR;
+		b_pack += AVX512_NR;
+	}
+
+	if (mr == AVX512_MR && nr == AVX512_NR)
+	{
+		__m512d alpha_v = _mm512_set1_pd(alpha);
+		__m512d beta_v = _mm512_set1_pd(beta);
+
+		for (int r = 0; r < AVX512_MR; r++)
+		{
+			for (int s = 0; s < AVX512_NR / 8; s++)
+			{
+				double *c_rs = &M(r, 8 * s, ldc, c);
+				__m512d v = _mm512_mul_pd(alpha_v, acc[r][s]);
+				if (beta != 0.0)
+					v = _mm512_fmadd_pd(beta_v, _mm512_loadu_pd(c_rs), v);
+				_mm512_storeu_pd(c_rs, v);
+			}
+		}
+	}
+	else
+	{
+		double tmp[AVX512_MR * AVX512_NR];
+		for (int r = 0; r < AVX512_MR; r++)
+			for (int s = 0; s < AVX512_NR / 8; s++)
+				_mm512_storeu_pd(&tmp[r * AVX512_NR + 8 * s], acc[r][s]);
+		store_border_block(tmp, AVX512_NR, c, ldc, mr, nr, alpha, beta);
+	}
+}
+#endif
+
+/*
+ * Picks the best micro-kernel supported by the CPU (through cpuid) when the
+ * library is loaded. The environment variable PPC_GEMM_KERNEL forces a
+ * specific kernel, as long as the CPU supports it.
+ */
+__attribute__((constructor))
+static void select_gemm_kernel(void)
+{
+	const gemm_kernel_t kernels[] = {
+#if defined(__x86_64__) || defined(__i386__)
+		{"avx512", AVX512_MR, AVX512_NR, micro_kernel_avx512},
+		{"avx2", AVX2_MR, AVX2_NR, micro_kernel_avx2},
+		{"sse2", SSE2_MR, SSE2_NR, micro_kernel_sse2},
+#endif
+		{"scalar", SCALAR_MR, SCALAR_NR, micro_kernel_scalar},
+	};
+	int quantity = sizeof(kernels) / sizeof(kernels[0]);
+	const char *forced = getenv("PPC_GEMM_KERNEL");
+
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+#endif
+
+	for (int i = 0; i < quantity; i++)
+	{
+		int supported = 1;
+
+#if defined(__x86_64__) || defined(__i386__)
+		if (strcmp(kernels[i].name, "avx512") == 0)
+			supported = __builtin_cpu_supports("avx512f");
+		else if (strcmp(kernels[i].name, "avx2") == 0)
+			supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+		else if (strcmp(kernels[i].name, "sse2") == 0)
+			supported = __builtin_cpu_supports("sse2");
+#endif
+
+		if (supported && (forced == NULL || strcmp(forced, kernels[i].name) == 0))
+		{
+			gemm_kernel = kernels[i];
+			return;
+		}
+	}
+
+	if (forced != NULL)
+		fprintf(stderr, "Warning: GEMM micro-kernel '%s' is not available on this CPU, using the scalar one\n", forced);
+
+	gemm_kernel = kernels[quantity - 1];
+}
+
+const char *ppc_gemm_kernel_name(void)
+{
+	return gemm_kernel.name;
+}
+
+long int ppc_gemm_row_block(void)
+{
+	return gemm_mc;
+}
+
+void ppc_gemm_get_blocking(long int *mc, long int *kc, long int *nc)
+{
+	*mc = gemm_mc;
+	*kc = gemm_kc;
+	*nc = gemm_nc;
+}
+
+void ppc_gemm_set_blocking(long int mc, long int kc, long int nc)
+{
+	// Rounded up to whole register blocks of the current micro-kernel
+	if (mc > 0)
+		gemm_mc = ((mc + gemm_kernel.mr - 1) / gemm_kernel.mr) * gemm_kernel.mr;
+	if (kc > 0)
+		gemm_kc = kc;
+	if (nc > 0)
+		gemm_nc = ((nc + gemm_kernel.nr - 1) / gemm_kernel.nr) * gemm_kernel.nr;
+}
+
+/*
+ * Copies an mc x kc block of A into panels of mr_max rows, with k varying
+ * slowest, so that the micro-kernel reads A sequentially. Rows missing to
+ * complete the last panel are zero-filled.
+ */
+static void pack_a(const double *a, long int lda, int mc, int kc, int mr_max, double *a_pack)
+{
+	for (int ir = 0; ir < mc; ir += mr_max)
+	{
+		int mr = (mc - ir < mr_max) ? mc - ir : mr_max;
+
+		for (int p = 0; p < kc; p++)
+		{
+			for (int r = 0; r < mr; r++)
+			{
+				a_pack[r] = M(ir + r, p, lda, a);
+			}
+			for (int r = mr; r < mr_max; r++)
+			{
+				a_pack[r] = 0.0;
+			}
+			a_pack += mr_max;
+		}
+	}
+}
+
+/*
+ * Copies a kc x nr panel of B into contiguous rows of nr_max elements.
+ */
+static void pack_b_panel(const double *b, long int ldb, int kc, int nr, int nr_max, double *b_pack)
+{
+	for (int p = 0; p < kc; p++)
+	{
+		for (int c = 0; c < nr; c++)
+		{
+			b_pack[c] = M(p, c, ldb, b);
+		}
+		for (int c = nr; c < nr_max; c++)
+		{
+			b_pack[c] = 0.0;
+		}
+		b_pack += nr_max;
+	}
+}
+
+/*
+ * Same packing from float matrixes: the values are converted to double
+ * while packed, so the double micro-kernels accumulate in double precision
+ * (see ppc_dsgemm())
+ */
+static void pack_a_float(const float *a, long int lda, int mc, int kc, int mr_max, double *a_pack)
+{
+	for (int ir = 0; ir < mc; ir += mr_max)
+	{
+		int mr = (mc - ir < mr_max) ? mc - ir : mr_max;
+
+		for (int p = 0; p < kc; p++)
+		{
+			for (int r = 0; r < mr; r++)
+			{
+				a_pack[r] = M(ir + r, p, lda, a);
+			}
+			for (int r = mr; r < mr_max; r++)
+			{
+				a_pack[r] = 0.0;
+			}
+			a_pack += mr_max;
+		}
+	}
+}
+
+static void pack_b_panel_float(const float *b, long int ldb, int kc, int nr, int nr_max, double *b_pack)
+{
+	for (int p = 0; p < kc; p++)
+	{
+		for (int c = 0; c < nr; c++)
+		{
+			b_pack[c] = M(p, c, ldb, b);
+		}
+		for (int c = nr; c < nr_max; c++)
+		{
+			b_pack[c] = 0.0;
+		}
+		b_pack += nr_max;
+	}
+}
+
+/*
+ * Packs the mc x kc block of A at (i, p), from a double or a float matrix
+ */
+static void pack_a_block(const void *a, int float_input, long int lda, long int i, long int p,
+						 int mc, int kc, int mr_max, double *a_pack)
+{
+	if (float_input)
+	{
+		const float *a_float = (const float *)a;
+		pack_a_float(&M(i, p, lda, a_float), lda, mc, kc, mr_max, a_pack);
+	}
+	else
+	{
+		const double *a_double = (const double *)a;
+		pack_a(&M(i, p, lda, a_double), lda, mc, kc, mr_max, a_pack);
+	}
+}
+
+/*
+ * Packs the kc x nr panel of B at (p, j), from a double or a float matrix
+ */
+static void pack_b_block(const void *b, int float_input, long int ldb, long int p, long int j,
+						 int kc, int nr, int nr_max, double *b_pack)
+{
+	if (float_input)
+	{
+		const float *b_float = (const float *)b;
+		pack_b_panel_float(&M(p, j, ldb, b_float), ldb, kc, nr, nr_max, b_pack);
+	}
+	else
+	{
+		const double *b_double = (const double *)b;
+		pack_b_panel(&M(p, j, ldb, b_double), ldb, kc, nr, nr_max, b_pack);
+	}
+}
+
+static void macro_kernel(int mc, int nc, int kc, const double *a_pack, const double *b_pack,
+						 double *c, long int ldc, double alpha, double beta)
+{
+	int mr_max = gemm_kernel.mr;
+	int nr_max = gemm_kernel.nr;
+
+	for (int jr = 0; jr < nc; jr += nr_max)
+	{
+		int nr = (nc - jr < nr_max) ? nc - jr : nr_max;
+
+		for (int ir = 0; ir < mc; ir += mr_max)
+		{
+			int mr = (mc - ir < mr_max) ? mc - ir : mr_max;
+
+			gemm_kernel.function(kc,
+								 &a_pack[(long int)ir * kc],
+								 &b_pack[(long int)jr * kc],
+								 &M(ir, jr, ldc, c), ldc, mr, nr, alpha, beta);
+		}
+	}
+}
+
+static size_t b_pack_size(long int n)
+{
+	long int nc_max = (n < gemm_nc) ? n : gemm_nc;
+
+	return sizeof(double) * gemm_kc * (nc_max + GEMM_NR_MAX);
+}
+
+static size_t a_pack_size(void)
+{
+	return sizeof(double) * (gemm_mc + GEMM_MR_MAX) * gemm_kc;
+}
+
+/*
+ * Loop nest of the blocked GEMM. With shared != 0 it must be called by every
+ * thread of the current team: the panel of B is packed cooperatively into
+ * the shared b_pack and the MC row blocks of A/C are split statically, so
+ * each thread always writes the same rows of C. With shared == 0 the calling
+ * thread does all the work alone.
+ * A and B are double matrixes, or float ones when float_input != 0.
+ * beta is applied on the first KC step only; later steps accumulate.
+ */
+static void gemm_loops(long int m, long int n, long int k, double alpha,
+					   const void *a, long int lda,
+					   const void *b, long int ldb, int float_input,
+					   double beta, double *c, long int ldc,
+					   double *a_pack, double *b_pack, int shared)
+{
+	int mr_max = gemm_kernel.mr;
+	int nr_max = gemm_kernel.nr;
+
+	for (long int jc = 0; jc < n; jc += gemm_nc)
+	{
+		int nc = (n - jc < gemm_nc) ? n - jc : gemm_nc;
+
+		for (long int pc = 0; pc < k; pc += gemm_kc)
+		{
+			int kc = (k - pc < gemm_kc) ? k - pc : gemm_kc;
+			double beta_pc = (pc == 0) ? beta : 1.0;
+
+			if (shared)
+			{
+				#pragma omp for schedule(static)
+				for (int jr = 0; jr < nc; jr += nr_max)
+				{
+					int nr = (nc - jr < nr_max) ? nc - jr : nr_max;
+					pack_b_block(b, float_input, ldb, pc, jc + jr, kc, nr, nr_max, &b_pack[(long int)jr * kc]);
+				}
+
+				#pragma omp for schedule(static)
+				for (long int ic = 0; ic < m; ic += gemm_mc)
+				{
+					int mc = (m - ic < gemm_mc) ? m - ic : gemm_mc;
+
+					pack_a_block(a, float_input, lda, ic, pc, mc, kc, mr_max, a_pack);
+					macro_kernel(mc, nc, kc, a_pack, b_pack, &M(ic, jc, ldc, c), ldc, alpha, beta_pc);
+				}
+			}
+			else
+			{
+				for (int jr = 0; jr < nc; jr += nr_max)
+				{
+					int nr = (nc - jr < nr_max) ? nc - jr : nr_max;
+					pack_b_block(b, float_input, ldb, pc, jc + jr, kc, nr, nr_max, &b_pack[(long int)jr * kc]);
+				}
+
+				for (long int ic = 0; ic < m; ic += gemm_mc)
+				{
+					int mc = (m - ic < gemm_mc) ? m - ic : gemm_mc;
+
+					pack_a_block(a, float_input, lda, ic, pc, mc, kc, mr_max, a_pack);
+					macro_kernel(mc, nc, kc, a_pack, b_pack, &M(ic, jc, ldc, c), ldc, alpha, beta_pc);
+				}
+			}
+		}
+	}
+}
+
+/*
+ * C = beta * C, used when there is no product to add (k == 0 or alpha == 0)
+ */
+static void scale_matrix(long int m, long int n, double beta, double *c, long int ldc)
+{
+	for (long int i = 0; i < m; i++)
+	{
+		for (long int j = 0; j < n; j++)
+		{
+			M(i, j, ldc, c) = (beta == 0.0) ? 0.0 : beta * M(i, j, ldc, c);
+		}
+	}
+}
+
+void ppc_dgemm(long int m, long int n, long int k,
+			   double alpha,
+			   const double *a, long int lda,
+			   const double *b, long int ldb,
+			   double beta,
+			   double *c, long int ldc)
+{
+	if (m <= 0 || n <= 0)
+		return;
+
+	if (k <= 0 || alpha == 0.0)
+	{
+		scale_matrix(m, n, beta, c, ldc);
+		return;
+	}
+
+	double *b_pack = (double *)aligned_alloc(64, b_pack_size(n));
+
+	// Called from inside a parallel region (a task, a batch item) the
+	// multiplication runs on the calling thread only
+	#pragma omp parallel if (!omp_in_parallel())
+	{
+		double *a_pack = (double *)aligned_alloc(64, a_pack_size());
+
+		gemm_loops(m, n, k, alpha, a, lda, b, ldb, 0, beta, c, ldc, a_pack, b_pack, 1);
+
+		free(a_pack);
+	}
+
+	free(b_pack);
+}
+
+void ppc_dsgemm(long int m, long int n, long int k,
+				double alpha,
+				const float *a, long int lda,
+				const float *b, long int ldb,
+				double beta,
+				double *c, long int ldc)
+{
+	if (m <= 0 || n <= 0)
+		return;
+
+	if (k <= 0 || alpha == 0.0)
+	{
+		scale_matrix(m, n, beta, c, ldc);
+		return;
+	}
+
+	double *b_pack = (double *)aligned_alloc(64, b_pack_size(n));
+
+	#pragma omp parallel if (!omp_in_parallel())
+	{
+		double *a_pack = (double *)aligned_alloc(64, a_pack_size());
+
+		gemm_loops(m, n, k, alpha, a, lda, b, ldb, 1, beta, c, ldc, a_pack, b_pack, 1);
+
+		free(a_pack);
+	}
+
+	free(b_pack);
+}
+
+void ppc_dgemm_batch(long int batch_count,
+					 long int m, long int n, long int k,
+					 double alpha,
+					 const double *const *a_array, long int lda,
+					 const double *const *b_array, long int ldb,
+					 double beta,
+					 double *const *c_array, long int ldc)
+{
+	if (batch_count <= 0 || m <= 0 || n <= 0)
+		return;
+
+	// Each thread multiplies whole items with its own packing buffers, so
+	// there is no synchronization inside a product
+	#pragma omp parallel
+	{
+		double *a_pack = (double *)aligned_alloc(64, a_pack_size());
+		double *b_pack = (double *)aligned_alloc(64, b_pack_size(n));
+
+		#pragma omp for schedule(dynamic, 4)
+		for (long int i = 0; i < batch_count; i++)
+		{
+			if (k <= 0 || alpha == 0.0)
+				scale_matrix(m, n, beta, c_array[i], ldc);
+			else
+				gemm_loops(m, n, k, alpha, a_array[i], lda, b_array[i], ldb, 0,
+						   beta, c_array[i], ldc, a_pack, b_pack, 0);
+		}
+
+		free(a_pack);
+		free(b_pack);
+	}
+}
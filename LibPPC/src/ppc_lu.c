@@ -0,0 +1,541 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <omp.h>
+
+#include <libppc.h>
+
+/*
+ * Blocked right-looking LU with partial pivoting (the LAPACK dgetrf
+ * algorithm). For each panel of LU_BLOCK columns:
+ *   1. the panel (all the lines below the diagonal) is factored, choosing
+ *      the pivots;
+ *   2. the pivot swaps are applied to the columns left and right of it;
+ *   3. the block line right of the panel becomes U12 = L11^-1 A12;
+ *   4. the trailing matrix is updated with A22 -= L21 * U12, a GEMM.
+ * Step 4 is ~all of the O(n^3) work, so the factorization runs at about
+ * ppc_dgemm() speed instead of streaming the trailing matrix once per pivot.
+ * The panel is factored recursively (halving its columns), so most of its
+ * updates are GEMMs too, down to LU_PANEL_BASE columns.
+ */
+#define LU_BLOCK 128
+
+// Panels this narrow are factored without recursion
+#define LU_PANEL_BASE 8
+
+// Columns each thread takes at a time in the swaps and triangular solves
+#define LU_COLUMN_CHUNK 256
+
+// Right-hand sides from which the solve updates are done with ppc_dgemm()
+#define LU_SOLVE_GEMM_COLUMNS 8
+
+void ppc_dlaswp(long int columns, double *a, long int lda, long int k1, long int k2, const int *ipiv)
+{
+	if (columns <= 0 || k1 >= k2)
+		return;
+
+	long int chunks = (columns + LU_COLUMN_CHUNK - 1) / LU_COLUMN_CHUNK;
+
+	// Each chunk of columns applies all the swaps in order, so the chunks
+	// are independent
+	#pragma omp parallel for schedule(static) if (chunks > 1 && !omp_in_parallel())
+	for (long int chunk = 0; chunk < chunks; chunk++)
+	{
+		long int first = chunk * LU_COLUMN_CHUNK;
+		long int last = (first + LU_COLUMN_CHUNK < columns) ? first + LU_COLUMN_CHUNK : columns;
+
+		for (long int i = k1; i < k2; i++)
+		{
+			long int p = ipiv[i];
+
+			if (p == i)
+				continue;
+
+			for (long int j = first; j < last; j++)
+			{
+				double value = M(i, j, lda, a);
+				M(i, j, lda, a) = M(p, j, lda, a);
+				M(p, j, lda, a) = value;
+			}
+		}
+	}
+}
+
+/*
+ * B = L^-1 B, with L order x order, unit lower triangular (the strict lower
+ * part of l), and B order x columns. Forward substitution line by line, in
+ * parallel over chunks of columns.
+ */
+static void solve_unit_lower(long int order, long int columns, const double *l, long int ldl,
+							 double *b, long int ldb)
+{
+	long int chunks = (columns + LU_COLUMN_CHUNK - 1) / LU_COLUMN_CHUNK;
+
+	#pragma omp parallel for schedule(static) if (chunks > 1 && !omp_in_parallel())
+	for (long int chunk = 0; chunk < chunks; chunk++)
+	{
+		long int first = chunk * LU_COLUMN_CHUNK;
+		long int last = (first + LU_COLUMN_CHUNK < columns) ? first + LU_COLUMN_CHUNK : columns;
+
+		for (long int i = 1; i < order; i++)
+			for (long int k = 0; k < i; k++)
+			{
+				double factor = M(i, k, ldl, l);
+
+				for (long int j = first; j < last; j++)
+					M(i, j, ldb, b) -= factor * M(k, j, ldb, b);
+			}
+	}
+}
+
+/*
+ * Recursive LU of a lines x columns panel (lines >= columns). ipiv gets the
+ * pivot lines relative to the top of the panel. Returns 0, or the 1-based
+ * index of the first exactly zero pivot.
+ */
+static int factor_panel(long int lines, long int columns, double *a, long int lda, int *ipiv)
+{
+	int info = 0;
+
+	if (columns <= LU_PANEL_BASE)
+	{
+		// Unblocked elimination: the few columns of each line are on one or
+		// two cache lines, so every line of the panel is loaded once per column
+		for (long int j = 0; j < columns; j++)
+		{
+			long int p = j;
+			double largest = fabs(M(j, j, lda, a));
+
+			for (long int i = j + 1; i < lines; i++)
+				if (fabs(M(i, j, lda, a)) > largest)
+				{
+					largest = fabs(M(i, j, lda, a));
+					p = i;
+				}
+
+			ipiv[j] = p;
+
+			// Singular column: nothing to eliminate, the factorization goes on
+			if (largest == 0.0)
+			{
+				if (info == 0)
+					info = j + 1;
+				continue;
+			}
+
+			if (p != j)
+				for (long int k = 0; k < columns; k++)
+				{
+					double value = M(j, k, lda, a);
+					M(j, k, lda, a) = M(p, k, lda, a);
+					M(p, k, lda, a) = value;
+				}
+
+			double inverse = 1.0 / M(j, j, lda, a);
+
+			for (long int i = j + 1; i < lines; i++)
+			{
+				double factor = M(i, j, lda, a) * inverse;
+
+				M(i, j, lda, a) = factor;
+				for (long int k = j + 1; k < columns; k++)
+					M(i, k, lda, a) -= factor * M(j, k, lda, a);
+			}
+		}
+
+		return info;
+	}
+
+	long int left = columns / 2, right = columns - left;
+
+	info = factor_panel(lines, left, a, lda, ipiv);
+
+	// [A12; A22] gets the swaps of the left half, then A12 = L11^-1 A12
+	// and A22 -= L21 * A12
+	ppc_dlaswp(right, &M(0, left, lda, a), lda, 0, left, ipiv);
+	solve_unit_lower(left, right, a, lda, &M(0, left, lda, a), lda);
+	ppc_dgemm(lines - left, right, left, -1.0, &M(left, 0, lda, a), lda, &M(0, left, lda, a), lda,
+			  1.0, &M(left, left, lda, a), lda);
+
+	int info_right = factor_panel(lines - left, right, &M(left, left, lda, a), lda, &ipiv[left]);
+
+	for (long int i = left; i < columns; i++)
+		ipiv[i] += left;
+
+	// The L21 lines move with the pivots of the right half
+	ppc_dlaswp(left, a, lda, left, columns, ipiv);
+
+	if (info == 0 && info_right != 0)
+		info = info_right + left;
+
+	return info;
+}
+
+int ppc_dgetrf(long int lines, long int columns, double *a, long int lda, int *ipiv)
+{
+	long int steps = (lines < columns) ? lines : columns;
+	int info = 0;
+
+	for (long int k = 0; k < steps; k += LU_BLOCK)
+	{
+		long int block = (steps - k < LU_BLOCK) ? steps - k : LU_BLOCK;
+
+		int info_panel = factor_panel(lines - k, block, &M(k, k, lda, a), lda, &ipiv[k]);
+
+		if (info == 0 && info_panel != 0)
+			info = info_panel + k;
+
+		for (long int i = k; i < k + block; i++)
+			ipiv[i] += k;
+
+		// Swaps on the columns left and right of the panel
+		ppc_dlaswp(k, a, lda, k, k + block, ipiv);
+		ppc_dlaswp(columns - k - block, &M(0, k + block, lda, a), lda, k, k + block, ipiv);
+
+		if (k + block < columns)
+		{
+			solve_unit_lower(block, columns - k - block, &M(k, k, lda, a), lda, &M(k, k + block, lda, a), lda);
+			ppc_dgemm(lines - k - block, columns - k - block, block,
+					  -1.0, &M(k + block, k, lda, a), lda,
+					  &M(k, k + block, lda, a), lda,
+					  1.0, &M(k + block, k + block, lda, a), lda);
+		}
+	}
+
+	return info;
+}
+
+/*
+ * Tiled LU: the same factorization as ppc_dgetrf(), with every operation on
+ * tiles as an OpenMP task ordered by depend clauses on one sentinel per tile.
+ * Step k has:
+ *   - the panel task, on all the tiles of tile column k from line k down
+ *     (partial pivoting needs the whole column);
+ *   - for each other tile column j, a task applying the swaps of the panel
+ *     (and, right of the panel, U[k][j] = L[k][k]^-1 A[k][j]);
+ *   - a GEMM task A[i][j] -= L[i][k] * U[k][j] per trailing tile.
+ * There is no barrier between steps: the panel of step k + 1 only waits for
+ * the updates of its own tile column, so it runs while the rest of the
+ * trailing matrix of step k is still being updated.
+ */
+int ppc_dgetrf_tiled(long int lines, long int columns, double *a, long int lda, int *ipiv, long int tile)
+{
+	long int steps = (lines < columns) ? lines : columns;
+	long int mt = (lines + tile - 1) / tile;
+	long int nt = (columns + tile - 1) / tile;
+	long int kt = (steps + tile - 1) / tile;
+	char *tiles = (char *)malloc(mt * nt);
+	int info = 0;
+
+	#pragma omp parallel if (!omp_in_parallel())
+	#pragma omp single
+	for (long int k = 0; k < kt; k++)
+	{
+		long int first = k * tile;
+		long int block = (steps - first < tile) ? steps - first : tile;
+
+		#pragma omp task depend(iterator(i = k : mt), inout : tiles[i * nt + k]) shared(info)
+		{
+			int info_panel = factor_panel(lines - first, block, &M(first, first, lda, a), lda, &ipiv[first]);
+
+			if (info == 0 && info_panel != 0)
+				info = info_panel + first;
+
+			for (long int i = first; i < first + block; i++)
+				ipiv[i] += first;
+		}
+
+		for (long int j = 0; j < nt; j++)
+		{
+			long int first_column = j * tile;
+			long int width = (columns - first_column < tile) ? columns - first_column : tile;
+
+			// On a wide matrix the last panel may be narrower than its tile
+			// column; the columns right of it are handled as a tile column
+			// right of the panel (with no lines below)
+			if (j == k)
+			{
+				first_column = first + block;
+				width -= block;
+
+				if (width <= 0)
+					continue;
+			}
+
+			#pragma omp task depend(in : tiles[k * nt + k]) depend(iterator(i = k : mt), inout : tiles[i * nt + j])
+			{
+				ppc_dlaswp(width, &M(0, first_column, lda, a), lda, first, first + block, ipiv);
+
+				if (j >= k)
+					solve_unit_lower(block, width, &M(first, first, lda, a), lda, &M(first, first_column, lda, a), lda);
+			}
+
+			if (j <= k)
+				continue;
+
+			for (long int i = k + 1; i < mt; i++)
+			{
+				long int first_line = i * tile;
+				long int height = (lines - first_line < tile) ? lines - first_line : tile;
+
+				#pragma omp task depend(in : tiles[i * nt + k], tiles[k * nt + j]) depend(inout : tiles[i * nt + j])
+				ppc_dgemm(height, width, block,
+						  -1.0, &M(first_line, first, lda, a), lda,
+						  &M(first, first_column, lda, a), lda,
+						  1.0, &M(first_line, first_column, lda, a), lda);
+			}
+		}
+	}
+
+	free(tiles);
+
+	return info;
+}
+
+/*
+ * B = U^-1 B, with U order x order, upper triangular (non-unit diagonal),
+ * and B order x columns. Backward substitution, in parallel over chunks of
+ * columns.
+ */
+static void solve_upper(long int order, long int columns, const double *u, long int ldu,
+						double *b, long int ldb)
+{
+	long int chunks = (columns + LU_COLUMN_CHUNK - 1) / LU_COLUMN_CHUNK;
+
+	#pragma omp parallel for schedule(static) if (chunks > 1 && !omp_in_parallel())
+	for (long int chunk = 0; chunk < chunks; chunk++)
+	{
+		long int first = chunk * LU_COLUMN_CHUNK;
+		long int last = (first + LU_COLUMN_CHUNK < columns) ? first + LU_COLUMN_CHUNK : columns;
+
+		for (long int i = order - 1; i >= 0; i--)
+		{
+			for (long int k = i + 1; k < order; k++)
+			{
+				double factor = M(i, k, ldu, u);
+
+				for (long int j = first; j < last; j++)
+					M(i, j, ldb, b) -= factor * M(k, j, ldb, b);
+			}
+
+			double inverse = 1.0 / M(i, i, ldu, u);
+
+			for (long int j = first; j < last; j++)
+				M(i, j, ldb, b) *= inverse;
+		}
+	}
+}
+
+/*
+ * C -= A * X, with A lines x depth and X depth x columns. Few right-hand
+ * sides make X too narrow for the GEMM packing to pay off, so each thread
+ * takes whole lines of A, read once and contiguously.
+ */
+static void update_solution(long int lines, long int columns, long int depth,
+							const double *a, long int lda, const double *x, long int ldx,
+							double *c, long int ldc)
+{
+	if (lines <= 0 || depth <= 0)
+		return;
+
+	if (columns >= LU_SOLVE_GEMM_COLUMNS)
+	{
+		ppc_dgemm(lines, columns, depth, -1.0, a, lda, x, ldx, 1.0, c, ldc);
+		return;
+	}
+
+	#pragma omp parallel for schedule(static) if (!omp_in_parallel())
+	for (long int i = 0; i < lines; i++)
+	{
+		for (long int j = 0; j < columns; j++)
+		{
+			double sum = 0.0;
+
+			#pragma omp simd reduction(+ : sum)
+			for (long int k = 0; k < depth; k++)
+				sum += M(i, k, lda, a) * M(k, j, ldx, x);
+
+			M(i, j, ldc, c) -= sum;
+		}
+	}
+}
+
+void ppc_dgetrs(long int order, long int nrhs, const double *lu, long int lda, const int *ipiv,
+				double *b, long int ldb)
+{
+	if (order <= 0 || nrhs <= 0)
+		return;
+
+	ppc_dlaswp(nrhs, b, ldb, 0, order, ipiv);
+
+	// L * Y = P * B, top to bottom: each block of lines is solved with the
+	// diagonal block of L and subtracted from all the lines below it
+	for (long int k = 0; k < order; k += LU_BLOCK)
+	{
+		long int block = (order - k < LU_BLOCK) ? order - k : LU_BLOCK;
+
+		solve_unit_lower(block, nrhs, &M(k, k, lda, lu), lda, &M(k, 0, ldb, b), ldb);
+		update_solution(order - k - block, nrhs, block, &M(k + block, k, lda, lu), lda,
+						&M(k, 0, ldb, b), ldb, &M(k + block, 0, ldb, b), ldb);
+	}
+
+	// U * X = Y, bottom to top
+	for (long int last = order; last > 0; last -= LU_BLOCK)
+	{
+		long int k = (last > LU_BLOCK) ? last - LU_BLOCK : 0;
+		long int block = last - k;
+
+		solve_upper(block, nrhs, &M(k, k, lda, lu), lda, &M(k, 0, ldb, b), ldb);
+		update_solution(k, nrhs, block, &M(0, k, lda, lu), lda, &M(k, 0, ldb, b), ldb, b, ldb);
+	}
+}
+
+/*
+ * Cholesky factorization A = L * L^T of the lower triangle of A, blocked
+ * right-looking as ppc_dgetrf(): for each block of CHOLESKY_BLOCK columns
+ *   1. the diagonal block is factored (L11);
+ *   2. the block below it becomes L21 = A21 * L11^-T;
+ *   3. the lower triangle of the trailing matrix gets A22 -= L21 * L21^T.
+ * No pivoting is needed and only the lower triangle is referenced, half of
+ * the LU work. Step 3 uses ppc_dgemm() with a transposed copy of L21 (the
+ * GEMM takes row-major operands), one task per block line of A22, so only
+ * the blocks on or below the diagonal are computed.
+ */
+#define CHOLESKY_BLOCK 128
+
+/*
+ * Unblocked Cholesky of an order x order diagonal block (dot product form,
+ * along the lines). Returns 0, or i + 1 if the minor of order i + 1 is not
+ * positive definite.
+ */
+static int cholesky_block(long int order, double *a, long int lda)
+{
+	for (long int j = 0; j < order; j++)
+	{
+		double diagonal = M(j, j, lda, a);
+
+		for (long int p = 0; p < j; p++)
+			diagonal -= M(j, p, lda, a) * M(j, p, lda, a);
+
+		// Also catches NaN
+		if (!(diagonal > 0.0))
+			return j + 1;
+
+		M(j, j, lda, a) = sqrt(diagonal);
+
+		double inverse = 1.0 / M(j, j, lda, a);
+
+		for (long int i = j + 1; i < order; i++)
+		{
+			double value = M(i, j, lda, a);
+
+			#pragma omp simd reduction(- : value)
+			for (long int p = 0; p < j; p++)
+				value -= M(i, p, lda, a) * M(j, p, lda, a);
+
+			M(i, j, lda, a) = value * inverse;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * inverse = L^-1, for L order x order lower triangular: line i of the
+ * inverse is (e_i - sum L[i][p] * line p) / L[i][i], vectorized along the lines
+ */
+static void invert_lower(long int order, const double *l, long int ldl, double *inverse)
+{
+	for (long int i = 0; i < order; i++)
+	{
+		for (long int j = 0; j < order; j++)
+			M(i, j, order, inverse) = (i == j) ? 1.0 : 0.0;
+
+		for (long int p = 0; p < i; p++)
+		{
+			double factor = M(i, p, ldl, l);
+
+			for (long int j = 0; j <= p; j++)
+				M(i, j, order, inverse) -= factor * M(p, j, order, inverse);
+		}
+
+		double scale = 1.0 / M(i, i, ldl, l);
+
+		for (long int j = 0; j <= i; j++)
+			M(i, j, order, inverse) *= scale;
+	}
+}
+
+int ppc_dpotrf(long int order, double *a, long int lda)
+{
+	// L21 of the current step and its transposition, L11^-1 and its transposition
+	double *work = (double *)malloc(sizeof(double) * CHOLESKY_BLOCK * order);
+	double *transposed = (double *)malloc(sizeof(double) * CHOLESKY_BLOCK * order);
+	double *inverse = (double *)malloc(sizeof(double) * CHOLESKY_BLOCK * CHOLESKY_BLOCK);
+	double *inverse_transposed = (double *)malloc(sizeof(double) * CHOLESKY_BLOCK * CHOLESKY_BLOCK);
+	int info = 0;
+
+	for (long int k = 0; k < order && info == 0; k += CHOLESKY_BLOCK)
+	{
+		long int block = (order - k < CHOLESKY_BLOCK) ? order - k : CHOLESKY_BLOCK;
+		long int below = order - k - block;
+		double *l11 = &M(k, k, lda, a);
+		double *l21 = &M(k + block, k, lda, a);
+
+		info = cholesky_block(block, l11, lda);
+		if (info != 0)
+		{
+			info += k;
+			break;
+		}
+
+		if (below == 0)
+			break;
+
+		// L21 = A21 * L11^-T as a GEMM with the (small) explicit inverse,
+		// instead of a triangular solve per line
+		invert_lower(block, l11, lda, inverse);
+		ppc_transpose(block, block, inverse, block, inverse_transposed, block);
+		ppc_dgemm(below, block, block, 1.0, l21, lda, inverse_transposed, block, 0.0, work, block);
+
+		#pragma omp parallel for schedule(static) if (!omp_in_parallel())
+		for (long int i = 0; i < below; i++)
+			memcpy(&M(i, 0, lda, l21), &M(i, 0, block, work), sizeof(double) * block);
+
+		ppc_transpose(below, block, work, block, transposed, below);
+
+		// A22 -= L21 * L21^T, block line by block line: the blocks left of
+		// the diagonal with one GEMM, the diagonal block through a buffer so
+		// its upper triangle is not written
+		long int block_lines = (below + CHOLESKY_BLOCK - 1) / CHOLESKY_BLOCK;
+
+		#pragma omp parallel for schedule(dynamic) if (!omp_in_parallel())
+		for (long int bi = 0; bi < block_lines; bi++)
+		{
+			long int first = bi * CHOLESKY_BLOCK;
+			long int height = (below - first < CHOLESKY_BLOCK) ? below - first : CHOLESKY_BLOCK;
+			double *a22 = &M(k + block + first, k + block, lda, a);
+			double *diagonal = (double *)malloc(sizeof(double) * height * height);
+
+			ppc_dgemm(height, first, block, -1.0, &M(first, 0, lda, l21), lda, transposed, below,
+					  1.0, a22, lda);
+			ppc_dgemm(height, height, block, 1.0, &M(first, 0, lda, l21), lda, &transposed[first], below,
+					  0.0, diagonal, height);
+
+			for (long int i = 0; i < height; i++)
+				for (long int j = 0; j <= i; j++)
+					M(i, first + j, lda, a22) -= M(i, j, height, diagonal);
+
+			free(diagonal);
+		}
+	}
+
+	free(work);
+	free(transposed);
+	free(inverse);
+	free(inverse_transposed);
+
+	return info;
+}
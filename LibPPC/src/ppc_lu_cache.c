@@ -0,0 +1,413 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+
+#include <omp.h>
+
+#include <libppc.h>
+
+/*
+ * Determinant, inverse and condition estimate from one LU factorization.
+ * The factorizations are kept in a small LRU cache keyed by a hash of the
+ * matrix (checked element by element on a hit), so asking for several of
+ * them, or for the same one again, factors the matrix once.
+ */
+#define LU_CACHE_ENTRIES 4
+
+// Columns of the inverse each thread solves at a time
+#define INVERSE_BLOCK 64
+
+// Iterations of the condition estimator (LAPACK dlacn2 uses 5)
+#define CONDITION_ITERATIONS 5
+
+typedef struct {
+
+	long int order;
+	uint64_t key;
+	double *original;
+	double *lu;
+	int *ipiv;
+	int info;
+	double norm1;
+
+	long int last_use;
+	int users;
+	int cached;
+
+} lu_entry_t;
+
+static lu_entry_t *cache[LU_CACHE_ENTRIES];
+static long int cache_clock = 0;
+static long int cache_hits = 0;
+static long int cache_misses = 0;
+
+/*
+ * Hash of the lines of a, one word per element; the lines are hashed in
+ * parallel and combined with their index, so the key does not depend on the
+ * number of threads
+ */
+static uint64_t hash_matrix(long int order, const double *a, long int lda)
+{
+	uint64_t key = (uint64_t)order * 0x9e3779b97f4a7c15ull;
+
+	#pragma omp parallel for schedule(static) reduction(+ : key) if (order > 256 && !omp_in_parallel())
+	for (long int i = 0; i < order; i++)
+	{
+		uint64_t hash = 0xcbf29ce484222325ull ^ (uint64_t)i;
+
+		for (long int j = 0; j < order; j++)
+		{
+			uint64_t bits;
+
+			memcpy(&bits, &M(i, j, lda, a), sizeof(bits));
+			hash = (hash ^ bits) * 0x100000001b3ull;
+		}
+
+		// Final mix, so that the sum of the lines does not cancel
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdull;
+		hash ^= hash >> 33;
+		key += hash;
+	}
+
+	return key;
+}
+
+static int same_matrix(const lu_entry_t *entry, long int order, const double *a, long int lda)
+{
+	for (long int i = 0; i < order; i++)
+		if (memcmp(&M(i, 0, order, entry->original), &M(i, 0, lda, a), sizeof(double) * order) != 0)
+			return 0;
+
+	return 1;
+}
+
+static void free_entry(lu_entry_t *entry)
+{
+	free(entry->original);
+	free(entry->lu);
+	free(entry->ipiv);
+	free(entry);
+}
+
+static lu_entry_t *factor_entry(long int order, const double *a, long int lda, uint64_t key)
+{
+	lu_entry_t *entry = (lu_entry_t *)calloc(1, sizeof(lu_entry_t));
+
+	if (entry == NULL)
+		return NULL;
+
+	entry->order = order;
+	entry->key = key;
+	entry->original = (double *)malloc(sizeof(double) * order * order);
+	entry->lu = (double *)malloc(sizeof(double) * order * order);
+	entry->ipiv = (int *)malloc(sizeof(int) * order);
+
+	if (entry->original == NULL || entry->lu == NULL || entry->ipiv == NULL)
+	{
+		free_entry(entry);
+		return NULL;
+	}
+
+	for (long int i = 0; i < order; i++)
+		memcpy(&M(i, 0, order, entry->original), &M(i, 0, lda, a), sizeof(double) * order);
+	memcpy(entry->lu, entry->original, sizeof(double) * order * order);
+
+	// ||A||_1, the largest column sum, for the condition number
+	for (long int j = 0; j < order; j++)
+	{
+		double sum = 0.0;
+
+		for (long int i = 0; i < order; i++)
+			sum += fabs(M(i, j, order, entry->original));
+		if (sum > entry->norm1)
+			entry->norm1 = sum;
+	}
+
+	entry->info = ppc_dgetrf(order, order, entry->lu, order, entry->ipiv);
+	entry->users = 1;
+
+	return entry;
+}
+
+/*
+ * Factorization of a, from the cache or computed (and cached, in the least
+ * recently used free slot). Release it with release_factorization().
+ */
+static lu_entry_t *acquire_factorization(long int order, const double *a, long int lda)
+{
+	uint64_t key = hash_matrix(order, a, lda);
+	lu_entry_t *entry = NULL;
+
+	#pragma omp critical(ppc_lu_cache)
+	{
+		for (int e = 0; e < LU_CACHE_ENTRIES && entry == NULL; e++)
+			if (cache[e] != NULL && cache[e]->key == key && cache[e]->order == order &&
+				same_matrix(cache[e], order, a, lda))
+				entry = cache[e];
+
+		if (entry != NULL)
+		{
+			entry->users++;
+			entry->last_use = ++cache_clock;
+			cache_hits++;
+		}
+		else
+			cache_misses++;
+	}
+
+	if (entry != NULL)
+		return entry;
+
+	// Factored out of the critical section, with all the threads
+	entry = factor_entry(order, a, lda, key);
+
+	if (entry == NULL)
+		return NULL;
+
+	#pragma omp critical(ppc_lu_cache)
+	{
+		int slot = -1;
+
+		for (int e = 0; e < LU_CACHE_ENTRIES; e++)
+		{
+			if (cache[e] == NULL)
+			{
+				slot = e;
+				break;
+			}
+			if (cache[e]->users == 0 && (slot < 0 || cache[e]->last_use < cache[slot]->last_use))
+				slot = e;
+		}
+
+		// With every entry in use the factorization is not cached
+		if (slot >= 0)
+		{
+			if (cache[slot] != NULL)
+				free_entry(cache[slot]);
+			cache[slot] = entry;
+			entry->cached = 1;
+		}
+		entry->last_use = ++cache_clock;
+	}
+
+	return entry;
+}
+
+static void release_factorization(lu_entry_t *entry)
+{
+	int discard;
+
+	#pragma omp critical(ppc_lu_cache)
+	{
+		entry->users--;
+		discard = !entry->cached && entry->users == 0;
+	}
+
+	if (discard)
+		free_entry(entry);
+}
+
+void ppc_lu_cache_clear(void)
+{
+	#pragma omp critical(ppc_lu_cache)
+	{
+		for (int e = 0; e < LU_CACHE_ENTRIES; e++)
+		{
+			if (cache[e] == NULL)
+				continue;
+
+			// An entry in use is freed by its last release
+			if (cache[e]->users == 0)
+				free_entry(cache[e]);
+			else
+				cache[e]->cached = 0;
+			cache[e] = NULL;
+		}
+	}
+}
+
+void ppc_lu_cache_stats(long int *hits, long int *misses)
+{
+	#pragma omp critical(ppc_lu_cache)
+	{
+		*hits = cache_hits;
+		*misses = cache_misses;
+	}
+}
+
+double ppc_log_determinant(long int order, const double *a, long int lda, int *sign)
+{
+	lu_entry_t *entry = acquire_factorization(order, a, lda);
+
+	if (entry == NULL)
+	{
+		*sign = 0;
+		return NAN;
+	}
+
+	double logarithm = 0.0;
+	int negative = 0;
+
+	for (long int i = 0; i < order; i++)
+	{
+		double pivot = M(i, i, order, entry->lu);
+
+		negative ^= (pivot < 0.0) ^ (entry->ipiv[i] != i);
+		logarithm += log(fabs(pivot));
+	}
+
+	*sign = (entry->info != 0) ? 0 : negative ? -1 : 1;
+
+	release_factorization(entry);
+
+	return (*sign == 0) ? -INFINITY : logarithm;
+}
+
+double ppc_determinant(long int order, const double *a, long int lda)
+{
+	int sign;
+	double logarithm = ppc_log_determinant(order, a, lda, &sign);
+
+	return (sign == 0) ? ((isnan(logarithm)) ? NAN : 0.0) : sign * exp(logarithm);
+}
+
+int ppc_inverse(long int order, const double *a, long int lda, double *inverse, long int ldi)
+{
+	lu_entry_t *entry = acquire_factorization(order, a, lda);
+
+	if (entry == NULL)
+		return -1;
+
+	int info = entry->info;
+
+	if (info == 0)
+	{
+		long int blocks = (order + INVERSE_BLOCK - 1) / INVERSE_BLOCK;
+
+		// Each thread solves A X = I on its blocks of columns, in place
+		#pragma omp parallel for schedule(dynamic) if (!omp_in_parallel())
+		for (long int b = 0; b < blocks; b++)
+		{
+			long int first = b * INVERSE_BLOCK;
+			long int width = (order - first < INVERSE_BLOCK) ? order - first : INVERSE_BLOCK;
+
+			for (long int i = 0; i < order; i++)
+				for (long int j = 0; j < width; j++)
+					M(i, first + j, ldi, inverse) = (i == first + j) ? 1.0 : 0.0;
+
+			ppc_dgetrs(order, width, entry->lu, order, entry->ipiv, &M(0, first, ldi, inverse), ldi);
+		}
+	}
+
+	release_factorization(entry);
+
+	return info;
+}
+
+/*
+ * A^T x = b with the factorization P A = L U: U^T z = b, L^T w = z, and
+ * x = P^T w (the swaps in reverse order); b is overwritten by x
+ */
+static void solve_transposed(long int order, const double *lu, const int *ipiv, double *b)
+{
+	for (long int i = 0; i < order; i++)
+	{
+		b[i] /= M(i, i, order, lu);
+		for (long int j = i + 1; j < order; j++)
+			b[j] -= M(i, j, order, lu) * b[i];
+	}
+
+	for (long int i = order - 1; i >= 0; i--)
+		for (long int j = 0; j < i; j++)
+			b[j] -= M(i, j, order, lu) * b[i];
+
+	for (long int k = order - 1; k >= 0; k--)
+	{
+		double value = b[k];
+		b[k] = b[ipiv[k]];
+		b[ipiv[k]] = value;
+	}
+}
+
+/*
+ * Hager's estimator of ||A^-1||_1 with Higham's refinements (LAPACK
+ * dlacn2): a few solves with A and A^T, O(n^2) each, looking for the
+ * column of A^-1 with the largest norm
+ */
+static double estimate_inverse_norm(long int order, const double *lu, const int *ipiv)
+{
+	double *x = (double *)malloc(sizeof(double) * order);
+	double *z = (double *)malloc(sizeof(double) * order);
+	double estimate = 0.0;
+	long int previous = -1;
+
+	for (long int i = 0; i < order; i++)
+		x[i] = 1.0 / order;
+
+	for (int iteration = 0; iteration < CONDITION_ITERATIONS; iteration++)
+	{
+		ppc_dgetrs(order, 1, lu, order, ipiv, x, 1);
+
+		double norm = 0.0;
+
+		for (long int i = 0; i < order; i++)
+			norm += fabs(x[i]);
+
+		if (iteration > 0 && norm <= estimate)
+			break;
+		estimate = norm;
+
+		for (long int i = 0; i < order; i++)
+			z[i] = (x[i] >= 0.0) ? 1.0 : -1.0;
+
+		solve_transposed(order, lu, ipiv, z);
+
+		long int largest = 0;
+
+		for (long int i = 1; i < order; i++)
+			if (fabs(z[i]) > fabs(z[largest]))
+				largest = i;
+
+		if (largest == previous)
+			break;
+		previous = largest;
+
+		for (long int i = 0; i < order; i++)
+			x[i] = (i == largest) ? 1.0 : 0.0;
+	}
+
+	// Alternative vector, for the matrixes that fool the iteration
+	for (long int i = 0; i < order; i++)
+		x[i] = ((i % 2) ? -1.0 : 1.0) * (1.0 + (order > 1 ? (double)i / (order - 1) : 0.0));
+
+	ppc_dgetrs(order, 1, lu, order, ipiv, x, 1);
+
+	double alternative = 0.0;
+
+	for (long int i = 0; i < order; i++)
+		alternative += fabs(x[i]);
+	alternative = 2.0 * alternative / (3.0 * order);
+
+	free(x);
+	free(z);
+
+	return (alternative > estimate) ? alternative : estimate;
+}
+
+double ppc_condition_estimate(long int order, const double *a, long int lda)
+{
+	lu_entry_t *entry = acquire_factorization(order, a, lda);
+
+	if (entry == NULL)
+		return NAN;
+
+	double condition = (entry->info != 0) ? INFINITY
+		: entry->norm1 * estimate_inverse_norm(order, entry->lu, entry->ipiv);
+
+	release_factorization(entry);
+
+	return condition;
+}
@@ -0,0 +1,279 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <dirent.h>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
+#include <omp.h>
+
+#include <libppc.h>
+
+/*
+ * Linux places a page on the NUMA node of the thread that first writes to
+ * it. The functions below make every thread touch the lines it will compute
+ * later: lines are grouped in blocks of block_lines and the blocks are split
+ * with schedule(static), the same partition a "#pragma omp for
+ * schedule(static)" over those blocks gets in the compute loop.
+ */
+
+double *alloc_double_matrix_first_touch(long int lines, long int columns, long int block_lines)
+{
+	double *matrix = NULL;
+
+	if (block_lines <= 0)
+		block_lines = 1;
+
+	// Page aligned, so that no page is shared by two threads' blocks unless
+	// the blocks themselves share it
+	if (posix_memalign((void **)&matrix, 4096, sizeof(double) * lines * columns) != 0)
+		return NULL;
+
+	long int blocks = (lines + block_lines - 1) / block_lines;
+
+	#pragma omp parallel for schedule(static)
+	for (long int bl = 0; bl < blocks; bl++)
+	{
+		long int first = bl * block_lines;
+		long int last = (first + block_lines < lines) ? first + block_lines : lines;
+
+		memset(&matrix[first * columns], 0, sizeof(double) * (last - first) * columns);
+	}
+
+	return matrix;
+}
+
+double *load_double_matrix_first_touch(const char *filename,
+									   long int number_of_lines,
+									   long int number_of_columns,
+									   long int block_lines)
+{
+	FILE *fd = fopen(filename, "rb");
+
+	if (fd == NULL)
+	{
+		perror("Error: could not open the matrix file");
+		return NULL;
+	}
+
+	if (block_lines <= 0)
+		block_lines = 1;
+
+	double *matrix = NULL;
+	size_t line_size = sizeof(double) * number_of_columns;
+
+	if (posix_memalign((void **)&matrix, 4096, line_size * number_of_lines) != 0)
+	{
+		fclose(fd);
+		return NULL;
+	}
+
+	long int blocks = (number_of_lines + block_lines - 1) / block_lines;
+	int read_error = 0;
+
+	// Each thread reads its own blocks straight into the pages it touches
+	#pragma omp parallel for schedule(static) reduction(| : read_error)
+	for (long int bl = 0; bl < blocks; bl++)
+	{
+		long int first = bl * block_lines;
+		long int last = (first + block_lines < number_of_lines) ? first + block_lines : number_of_lines;
+		size_t size = line_size * (last - first);
+		size_t done = 0;
+
+		while (done < size)
+		{
+			ssize_t n = pread(fileno(fd), (char *)&matrix[first * number_of_columns] + done,
+							  size - done, (off_t)(first * line_size + done));
+			if (n <= 0)
+			{
+				read_error = 1;
+				break;
+			}
+			done += n;
+		}
+	}
+
+	fclose(fd);
+
+	if (read_error)
+	{
+		fprintf(stderr, "Error: matrix size saved on file is not the requested by the function\n");
+		free(matrix);
+		return NULL;
+	}
+
+	return matrix;
+}
+
+double *generate_random_double_matrix_first_touch(long int lines,
+												  long int columns,
+												  long int block_lines)
+{
+	double *matrix = alloc_double_matrix_first_touch(lines, columns, block_lines);
+
+	if (matrix == NULL)
+		return NULL;
+
+	// Filled serially to keep the same rand() sequence as
+	// generate_random_double_matrix(); the pages are already placed
+	for (long int i = 0; i < lines; i++)
+	{
+		for (long int j = 0; j < columns; j++)
+		{
+			double x = rand() % (lines * columns);
+
+			matrix[i * columns + j] = x;
+		}
+	}
+
+	return matrix;
+}
+
+#ifdef __linux__
+/*
+ * NUMA node of a CPU: /sys/devices/system/cpu/cpuN has a "nodeM" link
+ */
+static int node_of_cpu(int cpu)
+{
+	char path[64];
+
+	snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d", cpu);
+
+	DIR *dir = opendir(path);
+	if (dir == NULL)
+		return 0;
+
+	int node = 0;
+	struct dirent *entry;
+
+	while ((entry = readdir(dir)) != NULL)
+	{
+		if (strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9')
+		{
+			node = atoi(&entry->d_name[4]);
+			break;
+		}
+	}
+
+	closedir(dir);
+
+	return node;
+}
+#endif
+
+int ppc_pin_threads(void)
+{
+	// An explicit OMP_PROC_BIND/OMP_PLACES (including OMP_PROC_BIND=false)
+	// is left to the OpenMP runtime
+	if (getenv("OMP_PROC_BIND") != NULL || getenv("OMP_PLACES") != NULL)
+		return 0;
+
+#ifdef __linux__
+	cpu_set_t allowed;
+
+	if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+		return 0;
+
+	int cpus[CPU_SETSIZE];
+	int nodes[CPU_SETSIZE];
+	int ncpus = 0;
+
+	for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+	{
+		if (CPU_ISSET(cpu, &allowed))
+		{
+			cpus[ncpus] = cpu;
+			nodes[ncpus] = node_of_cpu(cpu);
+			ncpus++;
+		}
+	}
+
+	// CPUs ordered by (node, id): spreading threads over this list puts the
+	// same number of consecutive threads on each node, like proc_bind(spread)
+	for (int i = 1; i < ncpus; i++)
+	{
+		int cpu = cpus[i], node = nodes[i], j = i - 1;
+
+		while (j >= 0 && (nodes[j] > node || (nodes[j] == node && cpus[j] > cpu)))
+		{
+			cpus[j + 1] = cpus[j];
+			nodes[j + 1] = nodes[j];
+			j--;
+		}
+		cpus[j + 1] = cpu;
+		nodes[j + 1] = node;
+	}
+
+	int pinned = 0;
+
+	#pragma omp parallel reduction(+ : pinned)
+	{
+		int nthreads = omp_get_num_threads();
+		int slot = (int)(((long int)omp_get_thread_num() * ncpus) / nthreads);
+		cpu_set_t mine;
+
+		CPU_ZERO(&mine);
+		CPU_SET(cpus[slot], &mine);
+
+		if (sched_setaffinity(0, sizeof(mine), &mine) == 0)
+			pinned = 1;
+	}
+
+	return pinned;
+#else
+	return 0;
+#endif
+}
+
+int numa_page_distribution(const void *data, size_t bytes, long int *pages_per_node, int max_nodes)
+{
+	for (int node = 0; node < max_nodes; node++)
+		pages_per_node[node] = 0;
+
+#if defined(__linux__) && defined(SYS_move_pages)
+	long int page_size = sysconf(_SC_PAGESIZE);
+	char *first = (char *)((unsigned long)data & ~(unsigned long)(page_size - 1));
+	char *end = (char *)data + bytes;
+	int highest_node = -1;
+
+	enum
+	{
+		QUERY_PAGES = 1024
+	};
+	void *pages[QUERY_PAGES];
+	int status[QUERY_PAGES];
+
+	for (char *page = first; page < end;)
+	{
+		int count = 0;
+
+		for (; count < QUERY_PAGES && page < end; count++, page += page_size)
+			pages[count] = page;
+
+		// With nodes == NULL move_pages only reports where each page is
+		if (syscall(SYS_move_pages, 0, (unsigned long)count, pages, NULL, status, 0) != 0)
+			return -1;
+
+		for (int i = 0; i < count; i++)
+		{
+			if (status[i] >= 0 && status[i] < max_nodes)
+			{
+				pages_per_node[status[i]]++;
+				if (status[i] > highest_node)
+					highest_node = status[i];
+			}
+		}
+	}
+
+	return highest_node + 1;
+#else
+	return -1;
+#endif
+}
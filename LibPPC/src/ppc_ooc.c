@@ -0,0 +1,94 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <libppc.h>
+
+/*
+ * Tiles of row-major double matrixes stored on binary files (the format of
+ * save_double_matrix()), so matrixes larger than the memory can be processed
+ * a piece at a time. pread()/pwrite() do not move the file position, so
+ * several threads can use the same file at once.
+ */
+
+static int transfer_tile(FILE *fd, int write,
+						 long int number_of_columns,
+						 long int first_line, long int first_column,
+						 long int lines, long int columns,
+						 double *tile, long int ld)
+{
+	// A tile with whole lines, stored without gaps, is one contiguous range
+	long int runs = (columns == number_of_columns && ld == columns) ? 1 : lines;
+	size_t run_size = sizeof(double) * columns * ((runs == 1) ? lines : 1);
+
+	for (long int r = 0; r < runs; r++)
+	{
+		char *data = (char *)&M(r, 0, ld, tile);
+		off_t offset = (off_t)sizeof(double) * ((first_line + r) * number_of_columns + first_column);
+		size_t done = 0;
+
+		while (done < run_size)
+		{
+			ssize_t n = write ? pwrite(fileno(fd), data + done, run_size - done, offset + done)
+							  : pread(fileno(fd), data + done, run_size - done, offset + done);
+			if (n <= 0)
+				return -1;
+
+			done += n;
+		}
+	}
+
+	return 0;
+}
+
+int read_double_matrix_tile(FILE *fd,
+							long int number_of_columns,
+							long int first_line, long int first_column,
+							long int lines, long int columns,
+							double *tile, long int ld)
+{
+	return transfer_tile(fd, 0, number_of_columns, first_line, first_column, lines, columns, tile, ld);
+}
+
+int write_double_matrix_tile(FILE *fd,
+							 long int number_of_columns,
+							 long int first_line, long int first_column,
+							 long int lines, long int columns,
+							 const double *tile, long int ld)
+{
+	return transfer_tile(fd, 1, number_of_columns, first_line, first_column, lines, columns, (double *)tile, ld);
+}
+
+int generate_random_double_matrix_file(long int lines, long int columns, const char *filename)
+{
+	FILE *fd = fopen(filename, "wb");
+
+	if (fd == NULL)
+	{
+		perror("Error: could not create the matrix file");
+		return -1;
+	}
+
+	double *line = (double *)malloc(sizeof(double) * columns);
+
+	// One line at a time, with the rand() sequence of
+	// generate_random_double_matrix()
+	for (long int i = 0; i < lines; i++)
+	{
+		for (long int j = 0; j < columns; j++)
+			line[j] = rand() % (lines * columns);
+
+		if (fwrite(line, sizeof(double), columns, fd) != (size_t)columns)
+		{
+			perror("Error: could not write the matrix file");
+			free(line);
+			fclose(fd);
+			return -1;
+		}
+	}
+
+	free(line);
+	fclose(fd);
+
+	return 0;
+}
@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <omp.h>
+
+#include <libppc.h>
+
+/*
+ * Tuning profile: a text file with one "<key> <size> <value>" entry per
+ * line ('#' starts a comment). It is read once, on the first lookup, and
+ * kept in memory; ppc_profile_set() rewrites the whole file.
+ */
+
+#define PROFILE_KEY_SIZE 64
+#define PROFILE_DEFAULT_FILE "ppc_profile.txt"
+
+/*
+ * Timing of a candidate parameter: the best of up to PROFILE_MAX_RUNS runs.
+ * A run that takes PROFILE_MAX_TIME seconds is timed once; shorter ones are
+ * repeated, at least 3 times and PROFILE_MIN_TIME seconds in total, so that
+ * the best time is not one disturbed by the rest of the system.
+ */
+#define PROFILE_MAX_RUNS 20
+#define PROFILE_MIN_TIME 0.5
+#define PROFILE_MAX_TIME 2.0
+
+typedef struct
+{
+	char key[PROFILE_KEY_SIZE];
+	long int size;
+	long int value;
+} profile_entry_t;
+
+static profile_entry_t *profile_entries = NULL;
+static long int profile_count = 0;
+static long int profile_capacity = 0;
+static int profile_loaded = 0;
+
+const char *ppc_profile_filename(void)
+{
+	const char *filename = getenv("PPC_PROFILE");
+
+	return (filename != NULL && filename[0] != '\0') ? filename : PROFILE_DEFAULT_FILE;
+}
+
+static void profile_append(const char *key, long int size, long int value)
+{
+	if (profile_count == profile_capacity)
+	{
+		profile_capacity = (profile_capacity == 0) ? 32 : 2 * profile_capacity;
+		profile_entries = (profile_entry_t *)realloc(profile_entries, sizeof(profile_entry_t) * profile_capacity);
+	}
+
+	strncpy(profile_entries[profile_count].key, key, PROFILE_KEY_SIZE - 1);
+	profile_entries[profile_count].key[PROFILE_KEY_SIZE - 1] = '\0';
+	profile_entries[profile_count].size = size;
+	profile_entries[profile_count].value = value;
+	profile_count++;
+}
+
+static void profile_load(void)
+{
+	if (profile_loaded)
+		return;
+
+	profile_loaded = 1;
+
+	FILE *fd = fopen(ppc_profile_filename(), "r");
+	if (fd == NULL)
+		return;
+
+	char line[256];
+	char key[PROFILE_KEY_SIZE];
+	long int size, value;
+
+	while (fgets(line, sizeof(line), fd) != NULL)
+	{
+		if (line[0] == '#')
+			continue;
+
+		if (sscanf(line, "%63s %ld %ld", key, &size, &value) == 3)
+			profile_append(key, size, value);
+	}
+
+	fclose(fd);
+}
+
+long int ppc_profile_get(const char *key, long int size, long int default_value)
+{
+	profile_load();
+
+	long int best = -1;
+	double best_distance = 0.0;
+
+	// Nearest size on a log scale: a profile for 1000 is a better guess for
+	// 1500 than one for 100
+	for (long int i = 0; i < profile_count; i++)
+	{
+		if (strcmp(profile_entries[i].key, key) != 0)
+			continue;
+
+		double distance = fabs(log((double)(size > 0 ? size : 1)) -
+							   log((double)(profile_entries[i].size > 0 ? profile_entries[i].size : 1)));
+
+		if (best < 0 || distance < best_distance)
+		{
+			best = i;
+			best_distance = distance;
+		}
+	}
+
+	return (best < 0) ? default_value : profile_entries[best].value;
+}
+
+int ppc_profile_set(const char *key, long int size, long int value)
+{
+	profile_load();
+
+	long int i;
+
+	for (i = 0; i < profile_count; i++)
+	{
+		if (strcmp(profile_entries[i].key, key) == 0 && profile_entries[i].size == size)
+		{
+			profile_entries[i].value = value;
+			break;
+		}
+	}
+
+	if (i == profile_count)
+		profile_append(key, size, value);
+
+	FILE *fd = fopen(ppc_profile_filename(), "w");
+	if (fd == NULL)
+	{
+		perror("Error: could not write the tuning profile");
+		return -1;
+	}
+
+	fprintf(fd, "# LibPPC tuning profile: <key> <size> <value>\n");
+
+	for (i = 0; i < profile_count; i++)
+	{
+		fprintf(fd, "%s %ld %ld\n", profile_entries[i].key, profile_entries[i].size, profile_entries[i].value);
+	}
+
+	fclose(fd);
+
+	return 0;
+}
+
+double ppc_profile_time(void (*setup)(void *), void (*run)(void *), void *context)
+{
+	double best = 0.0, total = 0.0;
+
+	for (int repetition = 0; repetition < PROFILE_MAX_RUNS; repetition++)
+	{
+		if (setup != NULL)
+			setup(context);
+
+		double start = omp_get_wtime();
+		run(context);
+		double time = omp_get_wtime() - start;
+
+		total += time;
+		if (repetition == 0 || time < best)
+			best = time;
+
+		if (total >= PROFILE_MAX_TIME || (repetition >= 2 && total >= PROFILE_MIN_TIME))
+			break;
+	}
+
+	return best;
+}
+
+int ppc_profile_tune_threads(void (*setup)(void *), void (*run)(void *), void *context, int pin_threads)
+{
+	int max_threads = omp_get_max_threads();
+	int best_threads = max_threads;
+	double best_time = -1.0;
+
+	// 1, 2, 4, ... threads, and the maximum
+	for (int threads = 1;; threads *= 2)
+	{
+		if (threads > max_threads)
+			threads = max_threads;
+
+		omp_set_num_threads(threads);
+		if (pin_threads)
+			ppc_pin_threads();
+
+		double time = ppc_profile_time(setup, run, context);
+		printf("  %d threads: %.6f s\n", threads, time);
+
+		if (best_time < 0.0 || time < best_time)
+		{
+			best_time = time;
+			best_threads = threads;
+		}
+
+		if (threads == max_threads)
+			break;
+	}
+
+	omp_set_num_threads(max_threads);
+	if (pin_threads)
+		ppc_pin_threads();
+
+	return best_threads;
+}
+
+void ppc_profile_apply_threads(const char *key, long int size)
+{
+	long int threads = ppc_profile_get(key, size, 0);
+
+	// A number of threads chosen with OMP_NUM_THREADS wins over the profile
+	if (threads > 0 && getenv("OMP_NUM_THREADS") == NULL)
+		omp_set_num_threads((int)threads);
+}
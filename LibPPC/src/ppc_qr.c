@@ -0,0 +1,375 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <omp.h>
+
+#include <libppc.h>
+
+/*
+ * Householder QR on row-major matrixes, blocked as LAPACK dgeqrf: each
+ * panel of QR_BLOCK columns is factored one reflector at a time, and its
+ * reflectors are applied to the rest of the matrix together, in the
+ * compact WY form H1 H2 ... Hb = I - V T V^T, as three GEMMs.
+ */
+#define QR_BLOCK 32
+
+// Bytes of a TSQR leaf: a block of lines this size stays in L2 while it is
+// factored
+#define TSQR_LEAF_BYTES (256 * 1024)
+
+/*
+ * Householder reflector of column j of the panel, lines j .. lines - 1:
+ * H = I - tau v v^T with v[j] = 1, so that H x = (beta, 0, ..., 0). v is
+ * stored below the diagonal and beta on it (LAPACK dlarfg).
+ */
+static double make_reflector(long int lines, double *a, long int lda, long int j)
+{
+	double alpha = M(j, j, lda, a);
+	double norm = 0.0;
+
+	for (long int i = j + 1; i < lines; i++)
+		norm += M(i, j, lda, a) * M(i, j, lda, a);
+
+	if (norm == 0.0)
+		return 0.0;
+
+	double beta = -copysign(sqrt(alpha * alpha + norm), alpha);
+	double scale = 1.0 / (alpha - beta);
+
+	for (long int i = j + 1; i < lines; i++)
+		M(i, j, lda, a) *= scale;
+	M(j, j, lda, a) = beta;
+
+	return (beta - alpha) / beta;
+}
+
+/*
+ * Unblocked QR of a panel (lines x width): the reflector of column j is
+ * applied to the columns j + 1 .. width - 1 with two passes over the lines,
+ * w = v^T A (along the lines) and A -= tau v w^T
+ */
+static void factor_panel(long int lines, long int width, double *a, long int lda, double *tau, double *w)
+{
+	for (long int j = 0; j < width && j < lines; j++)
+	{
+		tau[j] = make_reflector(lines, a, lda, j);
+
+		if (tau[j] == 0.0 || j + 1 == width)
+			continue;
+
+		for (long int c = j + 1; c < width; c++)
+			w[c] = M(j, c, lda, a);
+
+		for (long int i = j + 1; i < lines; i++)
+		{
+			double v = M(i, j, lda, a);
+
+			#pragma omp simd
+			for (long int c = j + 1; c < width; c++)
+				w[c] += v * M(i, c, lda, a);
+		}
+
+		for (long int c = j + 1; c < width; c++)
+			w[c] *= tau[j];
+
+		for (long int c = j + 1; c < width; c++)
+			M(j, c, lda, a) -= w[c];
+
+		for (long int i = j + 1; i < lines; i++)
+		{
+			double v = M(i, j, lda, a);
+
+			#pragma omp simd
+			for (long int c = j + 1; c < width; c++)
+				M(i, c, lda, a) -= v * w[c];
+		}
+	}
+}
+
+/*
+ * Compact WY form of the reflectors of a factored panel (lines x width):
+ * v (lines x width, unit lower trapezoidal) and vt = v^T are copied out of
+ * the panel, and the upper triangular t (width x width) is built so that
+ * H1 ... Hwidth = I - V T V^T (LAPACK dlarft), from the Gram matrix V^T V
+ */
+static void form_block_reflector(long int lines, long int width, const double *a, long int lda,
+								 const double *tau, double *v, double *vt, double *t)
+{
+	#pragma omp parallel for schedule(static) if (lines > 4096 && !omp_in_parallel())
+	for (long int i = 0; i < lines; i++)
+		for (long int c = 0; c < width; c++)
+			M(i, c, width, v) = (i > c) ? M(i, c, lda, a) : (i == c) ? 1.0 : 0.0;
+
+	ppc_transpose(lines, width, v, width, vt, lines);
+
+	// Gram matrix on t, then t is rebuilt column by column over its upper part
+	double *gram = (double *)malloc(sizeof(double) * width * width);
+
+	ppc_dgemm(width, width, lines, 1.0, vt, lines, v, width, 0.0, gram, width);
+
+	for (long int i = 0; i < width; i++)
+	{
+		for (long int r = 0; r < i; r++)
+		{
+			double sum = 0.0;
+
+			for (long int c = r; c < i; c++)
+				sum += M(r, c, width, t) * M(c, i, width, gram);
+
+			M(r, i, width, t) = -tau[i] * sum;
+		}
+
+		M(i, i, width, t) = tau[i];
+		for (long int r = i + 1; r < width; r++)
+			M(r, i, width, t) = 0.0;
+	}
+
+	free(gram);
+}
+
+/*
+ * C = (I - V T V^T)^T C = C - V (T^T (V^T C)), C lines x columns; w holds
+ * width x columns values
+ */
+static void apply_block_reflector(long int lines, long int width, const double *v, const double *vt,
+								  const double *t, double *c, long int ldc, long int columns, double *w)
+{
+	if (columns <= 0)
+		return;
+
+	ppc_dgemm(width, columns, lines, 1.0, vt, lines, c, ldc, 0.0, w, columns);
+
+	// w = T^T w in place, from the last line up (T^T is lower triangular)
+	for (long int i = width - 1; i >= 0; i--)
+	{
+		double *line = &M(i, 0, columns, w);
+
+		#pragma omp simd
+		for (long int j = 0; j < columns; j++)
+			line[j] *= M(i, i, width, t);
+
+		for (long int r = 0; r < i; r++)
+		{
+			const double *previous = &M(r, 0, columns, w);
+			double factor = M(r, i, width, t);
+
+			#pragma omp simd
+			for (long int j = 0; j < columns; j++)
+				line[j] += factor * previous[j];
+		}
+	}
+
+	ppc_dgemm(lines, columns, width, -1.0, v, width, w, columns, 1.0, c, ldc);
+}
+
+int ppc_dgeqrf(long int lines, long int columns, double *a, long int lda, double *tau)
+{
+	long int steps = (lines < columns) ? lines : columns;
+
+	if (steps <= 0)
+		return 0;
+
+	double *v = (double *)malloc(sizeof(double) * lines * QR_BLOCK);
+	double *vt = (double *)malloc(sizeof(double) * lines * QR_BLOCK);
+	double *t = (double *)malloc(sizeof(double) * QR_BLOCK * QR_BLOCK);
+	double *w = (double *)malloc(sizeof(double) * QR_BLOCK * (columns > QR_BLOCK ? columns : QR_BLOCK));
+
+	if (v == NULL || vt == NULL || t == NULL || w == NULL)
+	{
+		free(v);
+		free(vt);
+		free(t);
+		free(w);
+		return -1;
+	}
+
+	for (long int k = 0; k < steps; k += QR_BLOCK)
+	{
+		long int width = (steps - k < QR_BLOCK) ? steps - k : QR_BLOCK;
+		double *panel = &M(k, k, lda, a);
+
+		factor_panel(lines - k, width, panel, lda, &tau[k], w);
+
+		if (k + width < columns)
+		{
+			form_block_reflector(lines - k, width, panel, lda, &tau[k], v, vt, t);
+			apply_block_reflector(lines - k, width, v, vt, t, &M(k, k + width, lda, a), lda,
+								  columns - k - width, w);
+		}
+	}
+
+	free(v);
+	free(vt);
+	free(t);
+	free(w);
+
+	return 0;
+}
+
+void ppc_dormqr(long int lines, long int columns, long int nrhs, const double *qr, long int lda,
+				const double *tau, double *b, long int ldb)
+{
+	long int steps = (lines < columns) ? lines : columns;
+
+	if (steps <= 0 || nrhs <= 0)
+		return;
+
+	double *v = (double *)malloc(sizeof(double) * lines * QR_BLOCK);
+	double *vt = (double *)malloc(sizeof(double) * lines * QR_BLOCK);
+	double *t = (double *)malloc(sizeof(double) * QR_BLOCK * QR_BLOCK);
+	double *w = (double *)malloc(sizeof(double) * QR_BLOCK * nrhs);
+
+	for (long int k = 0; k < steps; k += QR_BLOCK)
+	{
+		long int width = (steps - k < QR_BLOCK) ? steps - k : QR_BLOCK;
+
+		form_block_reflector(lines - k, width, &M(k, k, lda, qr), lda, &tau[k], v, vt, t);
+		apply_block_reflector(lines - k, width, v, vt, t, &M(k, 0, ldb, b), ldb, nrhs, w);
+	}
+
+	free(v);
+	free(vt);
+	free(t);
+	free(w);
+}
+
+/*
+ * R X = B for the columns x columns upper triangle of r, B with nrhs
+ * columns; returns i + 1 if R[i][i] is zero
+ */
+static int solve_triangular_r(long int columns, long int nrhs, const double *r, long int ldr,
+							  double *b, long int ldb)
+{
+	for (long int i = columns - 1; i >= 0; i--)
+	{
+		double *line = &M(i, 0, ldb, b);
+
+		if (M(i, i, ldr, r) == 0.0)
+			return i + 1;
+
+		for (long int k = i + 1; k < columns; k++)
+		{
+			const double *solved = &M(k, 0, ldb, b);
+			double factor = M(i, k, ldr, r);
+
+			#pragma omp simd
+			for (long int j = 0; j < nrhs; j++)
+				line[j] -= factor * solved[j];
+		}
+
+		double inverse = 1.0 / M(i, i, ldr, r);
+
+		#pragma omp simd
+		for (long int j = 0; j < nrhs; j++)
+			line[j] *= inverse;
+	}
+
+	return 0;
+}
+
+int ppc_dgels(long int lines, long int columns, long int nrhs, double *a, long int lda, double *b, long int ldb)
+{
+	if (lines < columns)
+		return -1;
+
+	double *tau = (double *)malloc(sizeof(double) * (columns > 0 ? columns : 1));
+
+	if (ppc_dgeqrf(lines, columns, a, lda, tau) != 0)
+	{
+		free(tau);
+		return -1;
+	}
+
+	ppc_dormqr(lines, columns, nrhs, a, lda, tau, b, ldb);
+	free(tau);
+
+	return solve_triangular_r(columns, nrhs, a, lda, b, ldb);
+}
+
+/*
+ * Copies the upper triangle of the columns x columns block of a to r, with
+ * zeros below the diagonal
+ */
+static void copy_r(long int columns, const double *a, long int lda, double *r, long int ldr)
+{
+	for (long int i = 0; i < columns; i++)
+		for (long int j = 0; j < columns; j++)
+			M(i, j, ldr, r) = (j >= i) ? M(i, j, lda, a) : 0.0;
+}
+
+/*
+ * TSQR: the lines are split in leaves that fit in L2, every leaf is
+ * factored on its own (in parallel), and the R factors of the leaves are
+ * reduced pairwise, as a binary tree: the QR of [R_p; R_q] (2 columns x
+ * columns) is the R of both leaves. Each level is one parallel loop.
+ */
+int ppc_dtsqr(long int lines, long int columns, double *a, long int lda, double *r, long int ldr)
+{
+	if (lines < columns || columns <= 0)
+		return -1;
+
+	long int leaf = TSQR_LEAF_BYTES / (sizeof(double) * columns);
+
+	if (leaf < 2 * columns)
+		leaf = 2 * columns;
+
+	long int leaves = lines / leaf;
+
+	if (leaves < 1)
+		leaves = 1;
+
+	// Every leaf has at least columns lines, so its R is complete
+	double *factors = (double *)malloc(sizeof(double) * leaves * columns * columns);
+	double *stacked = (double *)malloc(sizeof(double) * omp_get_max_threads() * 2 * columns * columns);
+	double *tau = (double *)malloc(sizeof(double) * omp_get_max_threads() * columns);
+	int error = 0;
+
+	if (factors == NULL || stacked == NULL || tau == NULL)
+	{
+		free(factors);
+		free(stacked);
+		free(tau);
+		return -1;
+	}
+
+	#pragma omp parallel reduction(| : error) if (!omp_in_parallel())
+	{
+		double *my_tau = &tau[omp_get_thread_num() * columns];
+		double *my_stack = &stacked[omp_get_thread_num() * 2 * columns * columns];
+
+		#pragma omp for schedule(dynamic)
+		for (long int p = 0; p < leaves; p++)
+		{
+			long int first = p * lines / leaves;
+			long int last = (p + 1) * lines / leaves;
+
+			error |= ppc_dgeqrf(last - first, columns, &M(first, 0, lda, a), lda, my_tau) != 0;
+			copy_r(columns, &M(first, 0, lda, a), lda, &factors[p * columns * columns], columns);
+		}
+
+		for (long int distance = 1; distance < leaves; distance *= 2)
+		{
+			#pragma omp for schedule(dynamic)
+			for (long int p = 0; p < leaves - distance; p += 2 * distance)
+			{
+				double *top = &factors[p * columns * columns];
+				double *bottom = &factors[(p + distance) * columns * columns];
+
+				memcpy(my_stack, top, sizeof(double) * columns * columns);
+				memcpy(&my_stack[columns * columns], bottom, sizeof(double) * columns * columns);
+				error |= ppc_dgeqrf(2 * columns, columns, my_stack, columns, my_tau) != 0;
+				copy_r(columns, my_stack, columns, top, columns);
+			}
+		}
+	}
+
+	copy_r(columns, factors, columns, r, ldr);
+
+	free(factors);
+	free(stacked);
+	free(tau);
+
+	return error ? -1 : 0;
+}
@@ -0,0 +1,427 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <omp.h>
+
+#include <libppc.h>
+
+/*
+ * Single precision GEMM. Same structure as the double engine of ppc_gemm.c
+ * (packed panels of A and B, an MR x NR register block per micro-kernel
+ * call), but a vector register holds twice as many floats, so the register
+ * blocks are twice as wide, and KC/NC are larger since the packed panels
+ * take half the bytes.
+ */
+#define SGEMM_MR_MAX 8
+#define SGEMM_NR_MAX 32
+#define SGEMM_MC 144
+#define SGEMM_KC 384
+#define SGEMM_NC 4096
+
+typedef void (*sgemm_micro_kernel_t)(int kc, const float *a_pack, const float *b_pack,
+									 float *c, long int ldc, int mr, int nr,
+									 float alpha, float beta);
+
+typedef struct
+{
+	const char *name;
+	int mr;
+	int nr;
+	sgemm_micro_kernel_t function;
+} sgemm_kernel_t;
+
+static sgemm_kernel_t sgemm_kernel;
+
+/*
+ * Writes the border block computed in registers to C (see the double
+ * version in ppc_gemm.c). When beta is zero C is never read.
+ */
+static void store_border_block_float(const float *acc, int nr_max, float *c, long int ldc,
+									 int mr, int nr, float alpha, float beta)
+{
+	for (int r = 0; r < mr; r++)
+	{
+		for (int s = 0; s < nr; s++)
+		{
+			if (beta == 0.0f)
+				M(r, s, ldc, c) = alpha * acc[r * nr_max + s];
+			else
+				M(r, s, ldc, c) = alpha * acc[r * nr_max + s] + beta * M(r, s, ldc, c);
+		}
+	}
+}
+
+/*
+ * Portable 4x8 kernel
+ */
+#define SCALAR_MR 4
+#define SCALAR_NR 8
+static void sgemm_kernel_scalar(int kc, const float *a_pack, const float *b_pack,
+								float *c, long int ldc, int mr, int nr,
+								float alpha, float beta)
+{
+	float acc[SCALAR_MR * SCALAR_NR] = {0.0f};
+
+	for (int p = 0; p < kc; p++)
+	{
+		for (int r = 0; r < SCALAR_MR; r++)
+		{
+			float a_rp = a_pack[r];
+			for (int s = 0; s < SCALAR_NR; s++)
+			{
+				acc[r * SCALAR_NR + s] += a_rp * b_pack[s];
+			}
+		}
+		a_pack += SCALAR_MR;
+		b_pack += SCALAR_NR;
+	}
+
+	store_border_block_float(acc, SCALAR_NR, c, ldc, mr, nr, alpha, beta);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+/*
+ * SSE2: 4x8 block, 8 accumulators of 4 floats
+ */
+#define SSE2_MR 4
+#define SSE2_NR 8
+__attribute__((target("sse2")))
+static void sgemm_kernel_sse2(int kc, const float *a_pack, const float *b_pack,
+							  float *c, long int ldc, int mr, int nr,
+							  float alpha, float beta)
+{
+	__m128 acc[SSE2_MR][SSE2_NR / 4];
+
+	for (int r = 0; r < SSE2_MR; r++)
+		for (int s = 0; s < SSE2_NR / 4; s++)
+			acc[r][s] = _mm_setzero_ps();
+
+	for (int p = 0; p < kc; p++)
+	{
+		__m128 b0 = _mm_loadu_ps(&b_pack[0]);
+		__m128 b1 = _mm_loadu_ps(&b_pack[4]);
+
+		for (int r = 0; r < SSE2_MR; r++)
+		{
+			__m128 a_rp = _mm_set1_ps(a_pack[r]);
+			acc[r][0] = _mm_add_ps(acc[r][0], _mm_mul_ps(a_rp, b0));
+			acc[r][1] = _mm_add_ps(acc[r][1], _mm_mul_ps(a_rp, b1));
+		}
+		a_pack += SSE2_MR;
+		b_pack += SSE2_NR;
+	}
+
+	if (mr == SSE2_MR && nr == SSE2_NR)
+	{
+		__m128 alpha_v = _mm_set1_ps(alpha);
+		__m128 beta_v = _mm_set1_ps(beta);
+
+		for (int r = 0; r < SSE2_MR; r++)
+		{
+			for (int s = 0; s < SSE2_NR / 4; s++)
+			{
+				float *c_rs = &M(r, 4 * s, ldc, c);
+				__m128 v = _mm_mul_ps(alpha_v, acc[r][s]);
+				if (beta != 0.0f)
+					v = _mm_add_ps(v, _mm_mul_ps(beta_v, _mm_loadu_ps(c_rs)));
+				_mm_storeu_ps(c_rs, v);
+			}
+		}
+	}
+	else
+	{
+		float tmp[SSE2_MR * SSE2_NR];
+		for (int r = 0; r < SSE2_MR; r++)
+			for (int s = 0; s < SSE2_NR / 4; s++)
+				_mm_storeu_ps(&tmp[r * SSE2_NR + 4 * s], acc[r][s]);
+		store_border_block_float(tmp, SSE2_NR, c, ldc, mr, nr, alpha, beta);
+	}
+}
+
+/*
+ * AVX2 + FMA: 6x16 block, 12 accumulators of 8 floats
+ */
+#define AVX2_MR 6
+#define AVX2_NR 16
+__attribute__((target("avx2,fma")))
+static void sgemm_kernel_avx2(int kc, const float *a_pack, const float *b_pack,
+							  float *c, long int ldc, int mr, int nr,
+							  float alpha, float beta)
+{
+	__m256 acc[AVX2_MR][AVX2_NR / 8];
+
+	for (int r = 0; r < AVX2_MR; r++)
+		for (int s = 0; s < AVX2_NR / 8; s++)
+			acc[r][s] = _mm256_setzero_ps();
+
+	for (int p = 0; p < kc; p++)
+	{
+		__m256 b0 = _mm256_loadu_ps(&b_pack[0]);
+		__m256 b1 = _mm256_loadu_ps(&b_pack[8]);
+
+		for (int r = 0; r < AVX2_MR; r++)
+		{
+			__m256 a_rp = _mm256_broadcast_ss(&a_pack[r]);
+			acc[r][0] = _mm256_fmadd_ps(a_rp, b0, acc[r][0]);
+			acc[r][1] = _mm256_fmadd_ps(a_rp, b1, acc[r][1]);
+		}
+		a_pack += AVX2_MR;
+		b_pack += AVX2_NR;
+	}
+
+	if (mr == AVX2_MR && nr == AVX2_NR)
+	{
+		__m256 alpha_v = _mm256_set1_ps(alpha);
+		__m256 beta_v = _mm256_set1_ps(beta);
+
+		for (int r = 0; r < AVX2_MR; r++)
+		{
+			for (int s = 0; s < AVX2_NR / 8; s++)
+			{
+				float *c_rs = &M(r, 8 * s, ldc, c);
+				__m256 v = _mm256_mul_ps(alpha_v, acc[r][s]);
+				if (beta != 0.0f)
+					v = _mm256_fmadd_ps(beta_v, _mm256_loadu_ps(c_rs), v);
+				_mm256_storeu_ps(c_rs, v);
+			}
+		}
+	}
+	else
+	{
+		float tmp[AVX2_MR * AVX2_NR];
+		for (int r = 0; r < AVX2_MR; r++)
+			for (int s = 0; s < AVX2_NR / 8; s++)
+				_mm256_storeu_ps(&tmp[r * AVX2_NR + 8 * s], acc[r][s]);
+		store_border_block_float(tmp, AVX2_NR, c, ldc, mr, nr, alpha, beta);
+	}
+}
+
+/*
+ * AVX-512: 8x32 block, 16 accumulators of 16 floats
+ */
+#define AVX512_MR 8
+#define AVX512_NR 32
+__attribute__((target("avx512f")))
+static void sgemm_kernel_avx512(int kc, const float *a_pack, const float *b_pack,
+								float *c, long int ldc, int mr, int nr,
+								float alpha, float beta)
+{
+	__m512 acc[AVX512_MR][AVX512_NR / 16];
+
+	for (int r = 0; r < AVX512_MR; r++)
+		for (int s = 0; s < AVX512_NR / 16; s++)
+			acc[r][s] = _mm512_setzero_ps();
+
+	for (int p = 0; p < kc; p++)
+	{
+		__m512 b0 = _mm512_loadu_ps(&b_pack[0]);
+		__m512 b1 = _mm512_loadu_ps(&b_pack[16]);
+
+		for (int r = 0; r < AVX512_MR; r++)
+		{
+			__m512 a_rp = _mm512_set1_ps(a_pack[r]);
+			acc[r][0] = _mm512_fmadd_ps(a_rp, b0, acc[r][0]);
+			acc[r][1] = _mm512_fmadd_ps(a_rp, b1, acc[r][1]);
+		}
+		a_pack += AVX512_MR;
+		b_pack += AVX512_NR;
+	}
+
+	if (mr == AVX512_MR && nr == AVX512_NR)
+	{
+		__m512 alpha_v = _mm512_set1_ps(alpha);
+		__m512 beta_v = _mm512_set1_ps(beta);
+
+		for (int r = 0; r < AVX512_MR; r++)
+		{
+			for (int s = 0; s < AVX512_NR / 16; s++)
+			{
+				float *c_rs = &M(r, 16 * s, ldc, c);
+				__m512 v = _mm512_mul_ps(alpha_v, acc[r][s]);
+				if (beta != 0.0f)
+					v = _mm512_fmadd_ps(beta_v, _mm512_loadu_ps(c_rs), v);
+				_mm512_storeu_ps(c_rs, v);
+			}
+		}
+	}
+	else
+	{
+		float tmp[AVX512_MR * AVX512_NR];
+		for (int r = 0; r < AVX512_MR; r++)
+			for (int s = 0; s < AVX512_NR / 16; s++)
+				_mm512_storeu_ps(&tmp[r * AVX512_NR + 16 * s], acc[r][s]);
+		store_border_block_float(tmp, AVX512_NR, c, ldc, mr, nr, alpha, beta);
+	}
+}
+#endif
+
+/*
+ * Same choice as the double kernels: the best one the CPU supports, or the
+ * one named by PPC_GEMM_KERNEL
+ */
+__attribute__((constructor))
+static void select_sgemm_kernel(void)
+{
+	const sgemm_kernel_t kernels[] = {
+#if defined(__x86_64__) || defined(__i386__)
+		{"avx512", AVX512_MR, AVX512_NR, sgemm_kernel_avx512},
+		{"avx2", AVX2_MR, AVX2_NR, sgemm_kernel_avx2},
+		{"sse2", SSE2_MR, SSE2_NR, sgemm_kernel_sse2},
+#endif
+		{"scalar", SCALAR_MR, SCALAR_NR, sgemm_kernel_scalar},
+	};
+	int quantity = sizeof(kernels) / sizeof(kernels[0]);
+	const char *forced = getenv("PPC_GEMM_KERNEL");
+
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+#endif
+
+	for (int i = 0; i < quantity; i++)
+	{
+		int supported = 1;
+
+#if defined(__x86_64__) || defined(__i386__)
+		if (strcmp(kernels[i].name, "avx512") == 0)
+			supported = __builtin_cpu_supports("avx512f");
+		else if (strcmp(kernels[i].name, "avx2") == 0)
+			supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+		else if (strcmp(kernels[i].name, "sse2") == 0)
+			supported = __builtin_cpu_supports("sse2");
+#endif
+
+		if (supported && (forced == NULL || strcmp(forced, kernels[i].name) == 0))
+		{
+			sgemm_kernel = kernels[i];
+			return;
+		}
+	}
+
+	// ppc_gemm.c already warned about an unavailable PPC_GEMM_KERNEL
+	sgemm_kernel = kernels[quantity - 1];
+}
+
+static void pack_a_single(const float *a, long int lda, int mc, int kc, int mr_max, float *a_pack)
+{
+	for (int ir = 0; ir < mc; ir += mr_max)
+	{
+		int mr = (mc - ir < mr_max) ? mc - ir : mr_max;
+
+		for (int p = 0; p < kc; p++)
+		{
+			for (int r = 0; r < mr; r++)
+			{
+				a_pack[r] = M(ir + r, p, lda, a);
+			}
+			for (int r = mr; r < mr_max; r++)
+			{
+				a_pack[r] = 0.0f;
+			}
+			a_pack += mr_max;
+		}
+	}
+}
+
+static void pack_b_panel_single(const float *b, long int ldb, int kc, int nr, int nr_max, float *b_pack)
+{
+	for (int p = 0; p < kc; p++)
+	{
+		for (int c = 0; c < nr; c++)
+		{
+			b_pack[c] = M(p, c, ldb, b);
+		}
+		for (int c = nr; c < nr_max; c++)
+		{
+			b_pack[c] = 0.0f;
+		}
+		b_pack += nr_max;
+	}
+}
+
+static void macro_kernel_single(int mc, int nc, int kc, const float *a_pack, const float *b_pack,
+								float *c, long int ldc, float alpha, float beta)
+{
+	int mr_max = sgemm_kernel.mr;
+	int nr_max = sgemm_kernel.nr;
+
+	for (int jr = 0; jr < nc; jr += nr_max)
+	{
+		int nr = (nc - jr < nr_max) ? nc - jr : nr_max;
+
+		for (int ir = 0; ir < mc; ir += mr_max)
+		{
+			int mr = (mc - ir < mr_max) ? mc - ir : mr_max;
+
+			sgemm_kernel.function(kc,
+								  &a_pack[(long int)ir * kc],
+								  &b_pack[(long int)jr * kc],
+								  &M(ir, jr, ldc, c), ldc, mr, nr, alpha, beta);
+		}
+	}
+}
+
+void ppc_sgemm(long int m, long int n, long int k,
+			   float alpha,
+			   const float *a, long int lda,
+			   const float *b, long int ldb,
+			   float beta,
+			   float *c, long int ldc)
+{
+	if (m <= 0 || n <= 0)
+		return;
+
+	if (k <= 0 || alpha == 0.0f)
+	{
+		for (long int i = 0; i < m; i++)
+			for (long int j = 0; j < n; j++)
+				M(i, j, ldc, c) = (beta == 0.0f) ? 0.0f : beta * M(i, j, ldc, c);
+		return;
+	}
+
+	long int nc_max = (n < SGEMM_NC) ? n : SGEMM_NC;
+	float *b_pack = (float *)aligned_alloc(64, sizeof(float) * SGEMM_KC * (nc_max + SGEMM_NR_MAX));
+
+	// Same loop nest as gemm_loops() in ppc_gemm.c, with a team: B packed by
+	// all threads, MC row blocks of A/C split statically. Called from inside a
+	// parallel region it runs on the calling thread only
+	#pragma omp parallel if (!omp_in_parallel())
+	{
+		float *a_pack = (float *)aligned_alloc(64, sizeof(float) * (SGEMM_MC + SGEMM_MR_MAX) * SGEMM_KC);
+		int mr_max = sgemm_kernel.mr;
+		int nr_max = sgemm_kernel.nr;
+
+		for (long int jc = 0; jc < n; jc += SGEMM_NC)
+		{
+			int nc = (n - jc < SGEMM_NC) ? n - jc : SGEMM_NC;
+
+			for (long int pc = 0; pc < k; pc += SGEMM_KC)
+			{
+				int kc = (k - pc < SGEMM_KC) ? k - pc : SGEMM_KC;
+				float beta_pc = (pc == 0) ? beta : 1.0f;
+
+				#pragma omp for schedule(static)
+				for (int jr = 0; jr < nc; jr += nr_max)
+				{
+					int nr = (nc - jr < nr_max) ? nc - jr : nr_max;
+					pack_b_panel_single(&M(pc, jc + jr, ldb, b), ldb, kc, nr, nr_max, &b_pack[(long int)jr * kc]);
+				}
+
+				#pragma omp for schedule(static)
+				for (long int ic = 0; ic < m; ic += SGEMM_MC)
+				{
+					int mc = (m - ic < SGEMM_MC) ? m - ic : SGEMM_MC;
+
+					pack_a_single(&M(ic, pc, lda, a), lda, mc, kc, mr_max, a_pack);
+					macro_kernel_single(mc, nc, kc, a_pack, b_pack, &M(ic, jc, ldc, c), ldc, alpha, beta_pc);
+				}
+			}
+		}
+
+		free(a_pack);
+	}
+
+	free(b_pack);
+}
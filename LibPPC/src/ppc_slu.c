@@ -0,0 +1,427 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+
+#include <omp.h>
+
+#include <libppc.h>
+
+/*
+ * Single precision LU (same algorithm as ppc_dgetrf() in ppc_lu.c, on float,
+ * with ppc_sgemm() for the updates) and the mixed precision solver built on
+ * it: the O(n^3) factorization runs with twice the SIMD width and half the
+ * memory traffic, and the O(n^2) iterative refinement in double brings the
+ * solution back to double precision accuracy.
+ */
+#define SLU_BLOCK 128
+#define SLU_PANEL_BASE 8
+#define SLU_COLUMN_CHUNK 512
+#define SLU_SOLVE_GEMM_COLUMNS 8
+
+// LAPACK dsgesv limit: refinement that has not converged by then falls back
+// to the double precision solver
+#define REFINEMENT_MAX_ITERATIONS 30
+
+void ppc_slaswp(long int columns, float *a, long int lda, long int k1, long int k2, const int *ipiv)
+{
+	if (columns <= 0 || k1 >= k2)
+		return;
+
+	long int chunks = (columns + SLU_COLUMN_CHUNK - 1) / SLU_COLUMN_CHUNK;
+
+	#pragma omp parallel for schedule(static) if (chunks > 1 && !omp_in_parallel())
+	for (long int chunk = 0; chunk < chunks; chunk++)
+	{
+		long int first = chunk * SLU_COLUMN_CHUNK;
+		long int last = (first + SLU_COLUMN_CHUNK < columns) ? first + SLU_COLUMN_CHUNK : columns;
+
+		for (long int i = k1; i < k2; i++)
+		{
+			long int p = ipiv[i];
+
+			if (p == i)
+				continue;
+
+			for (long int j = first; j < last; j++)
+			{
+				float value = M(i, j, lda, a);
+				M(i, j, lda, a) = M(p, j, lda, a);
+				M(p, j, lda, a) = value;
+			}
+		}
+	}
+}
+
+// B = L^-1 B, L unit lower triangular (see solve_unit_lower() in ppc_lu.c)
+static void solve_unit_lower_float(long int order, long int columns, const float *l, long int ldl,
+								   float *b, long int ldb)
+{
+	long int chunks = (columns + SLU_COLUMN_CHUNK - 1) / SLU_COLUMN_CHUNK;
+
+	#pragma omp parallel for schedule(static) if (chunks > 1 && !omp_in_parallel())
+	for (long int chunk = 0; chunk < chunks; chunk++)
+	{
+		long int first = chunk * SLU_COLUMN_CHUNK;
+		long int last = (first + SLU_COLUMN_CHUNK < columns) ? first + SLU_COLUMN_CHUNK : columns;
+
+		for (long int i = 1; i < order; i++)
+			for (long int k = 0; k < i; k++)
+			{
+				float factor = M(i, k, ldl, l);
+
+				for (long int j = first; j < last; j++)
+					M(i, j, ldb, b) -= factor * M(k, j, ldb, b);
+			}
+	}
+}
+
+// B = U^-1 B, U upper triangular (see solve_upper() in ppc_lu.c)
+static void solve_upper_float(long int order, long int columns, const float *u, long int ldu,
+							  float *b, long int ldb)
+{
+	long int chunks = (columns + SLU_COLUMN_CHUNK - 1) / SLU_COLUMN_CHUNK;
+
+	#pragma omp parallel for schedule(static) if (chunks > 1 && !omp_in_parallel())
+	for (long int chunk = 0; chunk < chunks; chunk++)
+	{
+		long int first = chunk * SLU_COLUMN_CHUNK;
+		long int last = (first + SLU_COLUMN_CHUNK < columns) ? first + SLU_COLUMN_CHUNK : columns;
+
+		for (long int i = order - 1; i >= 0; i--)
+		{
+			for (long int k = i + 1; k < order; k++)
+			{
+				float factor = M(i, k, ldu, u);
+
+				for (long int j = first; j < last; j++)
+					M(i, j, ldb, b) -= factor * M(k, j, ldb, b);
+			}
+
+			float inverse = 1.0f / M(i, i, ldu, u);
+
+			for (long int j = first; j < last; j++)
+				M(i, j, ldb, b) *= inverse;
+		}
+	}
+}
+
+// C -= A * X (see update_solution() in ppc_lu.c)
+static void update_solution_float(long int lines, long int columns, long int depth,
+								  const float *a, long int lda, const float *x, long int ldx,
+								  float *c, long int ldc)
+{
+	if (lines <= 0 || depth <= 0)
+		return;
+
+	if (columns >= SLU_SOLVE_GEMM_COLUMNS)
+	{
+		ppc_sgemm(lines, columns, depth, -1.0f, a, lda, x, ldx, 1.0f, c, ldc);
+		return;
+	}
+
+	#pragma omp parallel for schedule(static) if (!omp_in_parallel())
+	for (long int i = 0; i < lines; i++)
+	{
+		for (long int j = 0; j < columns; j++)
+		{
+			float sum = 0.0f;
+
+			#pragma omp simd reduction(+ : sum)
+			for (long int k = 0; k < depth; k++)
+				sum += M(i, k, lda, a) * M(k, j, ldx, x);
+
+			M(i, j, ldc, c) -= sum;
+		}
+	}
+}
+
+// Recursive panel LU with partial pivoting (see factor_panel() in ppc_lu.c)
+static int factor_panel_float(long int lines, long int columns, float *a, long int lda, int *ipiv)
+{
+	int info = 0;
+
+	if (columns <= SLU_PANEL_BASE)
+	{
+		for (long int j = 0; j < columns; j++)
+		{
+			long int p = j;
+			float largest = fabsf(M(j, j, lda, a));
+
+			for (long int i = j + 1; i < lines; i++)
+				if (fabsf(M(i, j, lda, a)) > largest)
+				{
+					largest = fabsf(M(i, j, lda, a));
+					p = i;
+				}
+
+			ipiv[j] = p;
+
+			if (largest == 0.0f)
+			{
+				if (info == 0)
+					info = j + 1;
+				continue;
+			}
+
+			if (p != j)
+				for (long int k = 0; k < columns; k++)
+				{
+					float value = M(j, k, lda, a);
+					M(j, k, lda, a) = M(p, k, lda, a);
+					M(p, k, lda, a) = value;
+				}
+
+			float inverse = 1.0f / M(j, j, lda, a);
+
+			for (long int i = j + 1; i < lines; i++)
+			{
+				float factor = M(i, j, lda, a) * inverse;
+
+				M(i, j, lda, a) = factor;
+				for (long int k = j + 1; k < columns; k++)
+					M(i, k, lda, a) -= factor * M(j, k, lda, a);
+			}
+		}
+
+		return info;
+	}
+
+	long int left = columns / 2, right = columns - left;
+
+	info = factor_panel_float(lines, left, a, lda, ipiv);
+
+	ppc_slaswp(right, &M(0, left, lda, a), lda, 0, left, ipiv);
+	solve_unit_lower_float(left, right, a, lda, &M(0, left, lda, a), lda);
+	ppc_sgemm(lines - left, right, left, -1.0f, &M(left, 0, lda, a), lda, &M(0, left, lda, a), lda,
+			  1.0f, &M(left, left, lda, a), lda);
+
+	int info_right = factor_panel_float(lines - left, right, &M(left, left, lda, a), lda, &ipiv[left]);
+
+	for (long int i = left; i < columns; i++)
+		ipiv[i] += left;
+
+	ppc_slaswp(left, a, lda, left, columns, ipiv);
+
+	if (info == 0 && info_right != 0)
+		info = info_right + left;
+
+	return info;
+}
+
+int ppc_sgetrf(long int lines, long int columns, float *a, long int lda, int *ipiv)
+{
+	long int steps = (lines < columns) ? lines : columns;
+	int info = 0;
+
+	for (long int k = 0; k < steps; k += SLU_BLOCK)
+	{
+		long int block = (steps - k < SLU_BLOCK) ? steps - k : SLU_BLOCK;
+
+		int info_panel = factor_panel_float(lines - k, block, &M(k, k, lda, a), lda, &ipiv[k]);
+
+		if (info == 0 && info_panel != 0)
+			info = info_panel + k;
+
+		for (long int i = k; i < k + block; i++)
+			ipiv[i] += k;
+
+		ppc_slaswp(k, a, lda, k, k + block, ipiv);
+		ppc_slaswp(columns - k - block, &M(0, k + block, lda, a), lda, k, k + block, ipiv);
+
+		if (k + block < columns)
+		{
+			solve_unit_lower_float(block, columns - k - block, &M(k, k, lda, a), lda,
+								   &M(k, k + block, lda, a), lda);
+			ppc_sgemm(lines - k - block, columns - k - block, block,
+					  -1.0f, &M(k + block, k, lda, a), lda,
+					  &M(k, k + block, lda, a), lda,
+					  1.0f, &M(k + block, k + block, lda, a), lda);
+		}
+	}
+
+	return info;
+}
+
+void ppc_sgetrs(long int order, long int nrhs, const float *lu, long int lda, const int *ipiv,
+				float *b, long int ldb)
+{
+	if (order <= 0 || nrhs <= 0)
+		return;
+
+	ppc_slaswp(nrhs, b, ldb, 0, order, ipiv);
+
+	for (long int k = 0; k < order; k += SLU_BLOCK)
+	{
+		long int block = (order - k < SLU_BLOCK) ? order - k : SLU_BLOCK;
+
+		solve_unit_lower_float(block, nrhs, &M(k, k, lda, lu), lda, &M(k, 0, ldb, b), ldb);
+		update_solution_float(order - k - block, nrhs, block, &M(k + block, k, lda, lu), lda,
+							  &M(k, 0, ldb, b), ldb, &M(k + block, 0, ldb, b), ldb);
+	}
+
+	for (long int last = order; last > 0; last -= SLU_BLOCK)
+	{
+		long int k = (last > SLU_BLOCK) ? last - SLU_BLOCK : 0;
+		long int block = last - k;
+
+		solve_upper_float(block, nrhs, &M(k, k, lda, lu), lda, &M(k, 0, ldb, b), ldb);
+		update_solution_float(k, nrhs, block, &M(0, k, lda, lu), lda, &M(k, 0, ldb, b), ldb, b, ldb);
+	}
+}
+
+/*
+ * R = B - A * X and whether every column already satisfies the LAPACK
+ * dsgesv stopping test ||r||_inf <= ||x||_inf * ||A||_inf * eps * sqrt(order)
+ */
+static int refinement_residual(long int order, long int nrhs, const double *a, long int lda,
+							   const double *b, long int ldb, const double *x, long int ldx,
+							   double *r, double tolerance)
+{
+	if (nrhs >= SLU_SOLVE_GEMM_COLUMNS)
+	{
+		#pragma omp parallel for schedule(static)
+		for (long int i = 0; i < order; i++)
+			for (long int j = 0; j < nrhs; j++)
+				M(i, j, nrhs, r) = M(i, j, ldb, b);
+
+		ppc_dgemm(order, nrhs, order, -1.0, a, lda, x, ldx, 1.0, r, nrhs);
+	}
+	else
+	{
+		// Few right-hand sides: one pass over the lines of A, without packing
+		#pragma omp parallel for schedule(static)
+		for (long int i = 0; i < order; i++)
+		{
+			for (long int j = 0; j < nrhs; j++)
+			{
+				double sum = 0.0;
+
+				#pragma omp simd reduction(+ : sum)
+				for (long int k = 0; k < order; k++)
+					sum += M(i, k, lda, a) * M(k, j, ldx, x);
+
+				M(i, j, nrhs, r) = M(i, j, ldb, b) - sum;
+			}
+		}
+	}
+
+	for (long int j = 0; j < nrhs; j++)
+	{
+		double largest_r = 0.0, largest_x = 0.0;
+
+		for (long int i = 0; i < order; i++)
+		{
+			// A float factorization out of range gives infinities and NaNs
+			if (!isfinite(M(i, j, ldx, x)))
+				return 0;
+
+			largest_r = fmax(largest_r, fabs(M(i, j, nrhs, r)));
+			largest_x = fmax(largest_x, fabs(M(i, j, ldx, x)));
+		}
+
+		if (largest_r > largest_x * tolerance)
+			return 0;
+	}
+
+	return 1;
+}
+
+int ppc_dsgesv(long int order, long int nrhs, const double *a, long int lda,
+			   const double *b, long int ldb, double *x, long int ldx, int *iterations)
+{
+	float *lu = (float *)malloc(sizeof(float) * order * order);
+	float *correction = (float *)malloc(sizeof(float) * order * nrhs);
+	double *r = (double *)malloc(sizeof(double) * order * nrhs);
+	int *ipiv = (int *)malloc(sizeof(int) * order);
+	double norm_a = 0.0;
+	int info = 0;
+
+	#pragma omp parallel for schedule(static) reduction(max : norm_a)
+	for (long int i = 0; i < order; i++)
+	{
+		double sum = 0.0;
+
+		for (long int j = 0; j < order; j++)
+		{
+			M(i, j, order, lu) = (float)M(i, j, lda, a);
+			sum += fabs(M(i, j, lda, a));
+		}
+
+		if (sum > norm_a)
+			norm_a = sum;
+	}
+
+	double tolerance = norm_a * DBL_EPSILON * sqrt((double)order);
+
+	*iterations = -1;
+
+	if (ppc_sgetrf(order, order, lu, order, ipiv) == 0)
+	{
+		// x = (float LU)^-1 b
+		#pragma omp parallel for schedule(static)
+		for (long int i = 0; i < order; i++)
+			for (long int j = 0; j < nrhs; j++)
+				M(i, j, nrhs, correction) = (float)M(i, j, ldb, b);
+
+		ppc_sgetrs(order, nrhs, lu, order, ipiv, correction, nrhs);
+
+		#pragma omp parallel for schedule(static)
+		for (long int i = 0; i < order; i++)
+			for (long int j = 0; j < nrhs; j++)
+				M(i, j, ldx, x) = M(i, j, nrhs, correction);
+
+		// x += (float LU)^-1 (b - A x), with the residual in double
+		for (int iteration = 0; iteration <= REFINEMENT_MAX_ITERATIONS; iteration++)
+		{
+			if (refinement_residual(order, nrhs, a, lda, b, ldb, x, ldx, r, tolerance))
+			{
+				*iterations = iteration;
+				break;
+			}
+
+			if (iteration == REFINEMENT_MAX_ITERATIONS)
+				break;
+
+			#pragma omp parallel for schedule(static)
+			for (long int i = 0; i < order * nrhs; i++)
+				correction[i] = (float)r[i];
+
+			ppc_sgetrs(order, nrhs, lu, order, ipiv, correction, nrhs);
+
+			#pragma omp parallel for schedule(static)
+			for (long int i = 0; i < order; i++)
+				for (long int j = 0; j < nrhs; j++)
+					M(i, j, ldx, x) += M(i, j, nrhs, correction);
+		}
+	}
+
+	free(lu);
+	free(correction);
+	free(r);
+
+	// No float factorization (singular or out of float range) or no
+	// convergence: the whole solve in double
+	if (*iterations < 0)
+	{
+		double *lu_double = (double *)malloc(sizeof(double) * order * order);
+
+		for (long int i = 0; i < order; i++)
+			for (long int j = 0; j < order; j++)
+				M(i, j, order, lu_double) = M(i, j, lda, a);
+
+		for (long int i = 0; i < order; i++)
+			for (long int j = 0; j < nrhs; j++)
+				M(i, j, ldx, x) = M(i, j, ldb, b);
+
+		info = ppc_dgetrf(order, order, lu_double, order, ipiv);
+		if (info == 0)
+			ppc_dgetrs(order, nrhs, lu_double, order, ipiv, x, ldx);
+
+		free(lu_double);
+	}
+
+	free(ipiv);
+
+	return info;
+}
@@ -0,0 +1,525 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <omp.h>
+
+#include <libppc.h>
+
+/*
+ * Sparse matrixes in CSR (compressed sparse row): the nonzeros of line i are
+ * values[row_ptr[i] .. row_ptr[i + 1] - 1], on the columns with the same
+ * indexes in col_idx, sorted. The CSC form of a matrix is the CSR form of its
+ * transpose (see transpose_csr_matrix()).
+ *
+ * The parallel kernels split the lines so that every thread gets about the
+ * same work (nonzeros, or multiply-adds on SpGEMM) instead of the same number
+ * of lines, since the nonzeros of real matrixes are far from evenly spread.
+ */
+
+ppc_csr_t *alloc_csr_matrix(long int lines, long int columns, long int nnz)
+{
+	ppc_csr_t *csr = (ppc_csr_t *)malloc(sizeof(ppc_csr_t));
+
+	if (csr == NULL)
+		return NULL;
+
+	csr->lines = lines;
+	csr->columns = columns;
+	csr->nnz = nnz;
+	csr->row_ptr = (long int *)malloc(sizeof(long int) * (lines + 1));
+	csr->col_idx = (long int *)malloc(sizeof(long int) * (nnz > 0 ? nnz : 1));
+	csr->values = (double *)malloc(sizeof(double) * (nnz > 0 ? nnz : 1));
+
+	if (csr->row_ptr == NULL || csr->col_idx == NULL || csr->values == NULL)
+	{
+		free_csr_matrix(csr);
+		return NULL;
+	}
+
+	csr->row_ptr[0] = 0;
+
+	return csr;
+}
+
+void free_csr_matrix(ppc_csr_t *csr)
+{
+	if (csr == NULL)
+		return;
+
+	free(csr->row_ptr);
+	free(csr->col_idx);
+	free(csr->values);
+	free(csr);
+}
+
+/*
+ * Replaces counts[0 .. lines - 1] by their exclusive prefix sum on
+ * counts[0 .. lines]
+ */
+static long int prefix_sum(long int *counts, long int lines)
+{
+	long int total = 0;
+
+	for (long int i = 0; i < lines; i++)
+	{
+		long int count = counts[i];
+
+		counts[i] = total;
+		total += count;
+	}
+	counts[lines] = total;
+
+	return total;
+}
+
+/*
+ * First line where part "part" of "parts" starts, when line i weights
+ * prefix[i + 1] - prefix[i] + line_cost: the first line whose weighted
+ * prefix reaches part / parts of the total
+ */
+static long int balanced_boundary(const long int *prefix, long int lines, long int line_cost, int part, int parts)
+{
+	long int total = prefix[lines] - prefix[0] + line_cost * lines;
+	long int target = prefix[0] + (long int)((double)total * part / parts);
+	long int low = 0, high = lines;
+
+	while (low < high)
+	{
+		long int mid = low + (high - low) / 2;
+
+		if (prefix[mid] + line_cost * mid < target)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	return low;
+}
+
+/*
+ * Lines [*first, *last) of part "part" of "parts", balanced by weight
+ * (see balanced_boundary())
+ */
+static void balanced_lines(const long int *prefix, long int lines, long int line_cost,
+						   int part, int parts, long int *first, long int *last)
+{
+	*first = balanced_boundary(prefix, lines, line_cost, part, parts);
+	*last = (part + 1 == parts) ? lines : balanced_boundary(prefix, lines, line_cost, part + 1, parts);
+}
+
+ppc_csr_t *generate_random_csr_matrix(long int lines, long int columns, double density, unsigned int seed)
+{
+	if (density <= 0.0)
+		density = 1.0 / columns;
+	if (density > 1.0)
+		density = 1.0;
+
+	// Columns of a line are drawn with random steps of 1 .. gap, whose mean
+	// is 1 / density
+	double mean_gap = 2.0 / density - 1.0;
+	long int gap = (mean_gap > RAND_MAX) ? RAND_MAX : (long int)(mean_gap + 0.5);
+	if (gap < 1)
+		gap = 1;
+
+	long int *counts = (long int *)malloc(sizeof(long int) * (lines + 1));
+
+	// Every line has its own seed, so the matrix does not depend on the
+	// number of threads; the second pass replays the same sequence
+	#pragma omp parallel for schedule(dynamic, 256)
+	for (long int i = 0; i < lines; i++)
+	{
+		unsigned int state = seed ^ (unsigned int)(i * 2654435761u);
+		long int count = 0;
+
+		for (long int j = rand_r(&state) % gap; j < columns; j += 1 + rand_r(&state) % gap)
+		{
+			rand_r(&state);
+			count++;
+		}
+		counts[i] = count;
+	}
+
+	long int nnz = prefix_sum(counts, lines);
+	ppc_csr_t *csr = alloc_csr_matrix(lines, columns, nnz);
+
+	if (csr == NULL)
+	{
+		free(counts);
+		return NULL;
+	}
+
+	memcpy(csr->row_ptr, counts, sizeof(long int) * (lines + 1));
+	free(counts);
+
+	#pragma omp parallel for schedule(dynamic, 256)
+	for (long int i = 0; i < lines; i++)
+	{
+		unsigned int state = seed ^ (unsigned int)(i * 2654435761u);
+		long int p = csr->row_ptr[i];
+
+		for (long int j = rand_r(&state) % gap; j < columns; j += 1 + rand_r(&state) % gap)
+		{
+			csr->col_idx[p] = j;
+			csr->values[p] = (double)(rand_r(&state) % 10 + 1);
+			p++;
+		}
+	}
+
+	return csr;
+}
+
+ppc_csr_t *dense_to_csr_matrix(const double *matrix, long int lines, long int columns)
+{
+	long int *counts = (long int *)malloc(sizeof(long int) * (lines + 1));
+
+	#pragma omp parallel for schedule(static)
+	for (long int i = 0; i < lines; i++)
+	{
+		long int count = 0;
+
+		for (long int j = 0; j < columns; j++)
+		{
+			if (M(i, j, columns, matrix) != 0.0)
+				count++;
+		}
+		counts[i] = count;
+	}
+
+	long int nnz = prefix_sum(counts, lines);
+	ppc_csr_t *csr = alloc_csr_matrix(lines, columns, nnz);
+
+	if (csr == NULL)
+	{
+		free(counts);
+		return NULL;
+	}
+
+	memcpy(csr->row_ptr, counts, sizeof(long int) * (lines + 1));
+	free(counts);
+
+	#pragma omp parallel for schedule(static)
+	for (long int i = 0; i < lines; i++)
+	{
+		long int p = csr->row_ptr[i];
+
+		for (long int j = 0; j < columns; j++)
+		{
+			if (M(i, j, columns, matrix) != 0.0)
+			{
+				csr->col_idx[p] = j;
+				csr->values[p] = M(i, j, columns, matrix);
+				p++;
+			}
+		}
+	}
+
+	return csr;
+}
+
+double *csr_to_dense_matrix(const ppc_csr_t *csr)
+{
+	double *matrix = (double *)malloc(sizeof(double) * csr->lines * csr->columns);
+
+	if (matrix == NULL)
+		return NULL;
+
+	#pragma omp parallel for schedule(static)
+	for (long int i = 0; i < csr->lines; i++)
+	{
+		memset(&M(i, 0, csr->columns, matrix), 0, sizeof(double) * csr->columns);
+
+		for (long int p = csr->row_ptr[i]; p < csr->row_ptr[i + 1]; p++)
+			M(i, csr->col_idx[p], csr->columns, matrix) = csr->values[p];
+	}
+
+	return matrix;
+}
+
+ppc_csr_t *transpose_csr_matrix(const ppc_csr_t *csr)
+{
+	ppc_csr_t *transpose = alloc_csr_matrix(csr->columns, csr->lines, csr->nnz);
+
+	if (transpose == NULL)
+		return NULL;
+
+	long int *next = (long int *)calloc(csr->columns + 1, sizeof(long int));
+
+	for (long int p = 0; p < csr->nnz; p++)
+		next[csr->col_idx[p]]++;
+
+	prefix_sum(next, csr->columns);
+	memcpy(transpose->row_ptr, next, sizeof(long int) * (csr->columns + 1));
+
+	// Lines are visited in order, so the indexes of every new line end up sorted
+	for (long int i = 0; i < csr->lines; i++)
+	{
+		for (long int p = csr->row_ptr[i]; p < csr->row_ptr[i + 1]; p++)
+		{
+			long int q = next[csr->col_idx[p]]++;
+
+			transpose->col_idx[q] = i;
+			transpose->values[q] = csr->values[p];
+		}
+	}
+
+	free(next);
+
+	return transpose;
+}
+
+/*
+ * File layout: lines, columns and nnz (long int), then row_ptr, col_idx and
+ * values, all in binary
+ */
+int save_csr_matrix(const ppc_csr_t *csr, const char *filename)
+{
+	FILE *fd = fopen(filename, "wb");
+
+	if (fd == NULL)
+	{
+		perror("Error: could not create the sparse matrix file");
+		return -1;
+	}
+
+	long int header[3] = {csr->lines, csr->columns, csr->nnz};
+	int error = 0;
+
+	error |= fwrite(header, sizeof(long int), 3, fd) != 3;
+	error |= fwrite(csr->row_ptr, sizeof(long int), csr->lines + 1, fd) != (size_t)(csr->lines + 1);
+	error |= fwrite(csr->col_idx, sizeof(long int), csr->nnz, fd) != (size_t)csr->nnz;
+	error |= fwrite(csr->values, sizeof(double), csr->nnz, fd) != (size_t)csr->nnz;
+
+	fclose(fd);
+
+	if (error)
+	{
+		fprintf(stderr, "Error: could not write the sparse matrix file\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+ppc_csr_t *load_csr_matrix(const char *filename)
+{
+	FILE *fd = fopen(filename, "rb");
+
+	if (fd == NULL)
+	{
+		perror("Error: could not open the sparse matrix file");
+		return NULL;
+	}
+
+	long int header[3];
+
+	if (fread(header, sizeof(long int), 3, fd) != 3 || header[0] < 0 || header[1] < 0 || header[2] < 0)
+	{
+		fprintf(stderr, "Error: %s is not a sparse matrix file\n", filename);
+		fclose(fd);
+		return NULL;
+	}
+
+	ppc_csr_t *csr = alloc_csr_matrix(header[0], header[1], header[2]);
+
+	if (csr == NULL)
+	{
+		fclose(fd);
+		return NULL;
+	}
+
+	int error = 0;
+
+	error |= fread(csr->row_ptr, sizeof(long int), csr->lines + 1, fd) != (size_t)(csr->lines + 1);
+	error |= fread(csr->col_idx, sizeof(long int), csr->nnz, fd) != (size_t)csr->nnz;
+	error |= fread(csr->values, sizeof(double), csr->nnz, fd) != (size_t)csr->nnz;
+
+	fclose(fd);
+
+	if (error || csr->row_ptr[0] != 0 || csr->row_ptr[csr->lines] != csr->nnz)
+	{
+		fprintf(stderr, "Error: sparse matrix file %s is truncated or corrupted\n", filename);
+		free_csr_matrix(csr);
+		return NULL;
+	}
+
+	return csr;
+}
+
+void ppc_csr_spmv(const ppc_csr_t *a, const double *x, double *y)
+{
+	#pragma omp parallel
+	{
+		long int first, last;
+
+		// A line costs its nonzeros plus a fixed overhead, so long runs of
+		// empty lines get split too
+		balanced_lines(a->row_ptr, a->lines, 1, omp_get_thread_num(), omp_get_num_threads(), &first, &last);
+
+		for (long int i = first; i < last; i++)
+		{
+			double sum = 0.0;
+
+			for (long int p = a->row_ptr[i]; p < a->row_ptr[i + 1]; p++)
+				sum += a->values[p] * x[a->col_idx[p]];
+
+			y[i] = sum;
+		}
+	}
+}
+
+static int compare_indexes(const void *a, const void *b)
+{
+	long int x = *(const long int *)a, y = *(const long int *)b;
+
+	return (x > y) - (x < y);
+}
+
+// Lines of C are mostly short: insertion sort avoids the qsort() calls
+static void sort_indexes(long int *indexes, long int count)
+{
+	if (count > 64)
+	{
+		qsort(indexes, count, sizeof(long int), compare_indexes);
+		return;
+	}
+
+	for (long int i = 1; i < count; i++)
+	{
+		long int value = indexes[i], j = i - 1;
+
+		while (j >= 0 && indexes[j] > value)
+		{
+			indexes[j + 1] = indexes[j];
+			j--;
+		}
+		indexes[j + 1] = value;
+	}
+}
+
+ppc_csr_t *ppc_csr_spgemm(const ppc_csr_t *a, const ppc_csr_t *b)
+{
+	if (a->columns != b->lines)
+		return NULL;
+
+	long int lines = a->lines, columns = b->columns;
+
+	// Multiply-adds of every line, the work the lines are balanced by
+	long int *work = (long int *)malloc(sizeof(long int) * (lines + 1));
+	long int *counts = (long int *)malloc(sizeof(long int) * (lines + 1));
+
+	#pragma omp parallel for schedule(static)
+	for (long int i = 0; i < lines; i++)
+	{
+		long int products = 0;
+
+		for (long int p = a->row_ptr[i]; p < a->row_ptr[i + 1]; p++)
+			products += b->row_ptr[a->col_idx[p] + 1] - b->row_ptr[a->col_idx[p]];
+
+		work[i] = products;
+	}
+	prefix_sum(work, lines);
+
+	ppc_csr_t *c = NULL;
+	int failed = 0;
+
+	#pragma omp parallel
+	{
+		long int first, last;
+
+		balanced_lines(work, lines, 1, omp_get_thread_num(), omp_get_num_threads(), &first, &last);
+
+		// Dense accumulator of one line of C; marker[j] == i when column j
+		// already has a value on line i
+		long int *marker = (long int *)malloc(sizeof(long int) * (columns > 0 ? columns : 1));
+		long int *line_columns = (long int *)malloc(sizeof(long int) * (columns > 0 ? columns : 1));
+		double *accumulator = (double *)malloc(sizeof(double) * (columns > 0 ? columns : 1));
+
+		for (long int j = 0; j < columns; j++)
+			marker[j] = -1;
+
+		// Symbolic phase: nonzeros of every line of C
+		for (long int i = first; i < last; i++)
+		{
+			long int count = 0;
+
+			for (long int p = a->row_ptr[i]; p < a->row_ptr[i + 1]; p++)
+			{
+				long int k = a->col_idx[p];
+
+				for (long int q = b->row_ptr[k]; q < b->row_ptr[k + 1]; q++)
+				{
+					if (marker[b->col_idx[q]] != i)
+					{
+						marker[b->col_idx[q]] = i;
+						count++;
+					}
+				}
+			}
+			counts[i] = count;
+		}
+
+		#pragma omp barrier
+
+		#pragma omp single
+		{
+			long int nnz = prefix_sum(counts, lines);
+
+			c = alloc_csr_matrix(lines, columns, nnz);
+			if (c != NULL)
+				memcpy(c->row_ptr, counts, sizeof(long int) * (lines + 1));
+			else
+				failed = 1;
+		}
+
+		if (!failed)
+		{
+			for (long int j = 0; j < columns; j++)
+				marker[j] = -1;
+
+			// Numeric phase, on the same lines
+			for (long int i = first; i < last; i++)
+			{
+				long int count = 0;
+
+				for (long int p = a->row_ptr[i]; p < a->row_ptr[i + 1]; p++)
+				{
+					long int k = a->col_idx[p];
+					double value = a->values[p];
+
+					for (long int q = b->row_ptr[k]; q < b->row_ptr[k + 1]; q++)
+					{
+						long int j = b->col_idx[q];
+
+						if (marker[j] != i)
+						{
+							marker[j] = i;
+							accumulator[j] = 0.0;
+							line_columns[count++] = j;
+						}
+						accumulator[j] += value * b->values[q];
+					}
+				}
+
+				sort_indexes(line_columns, count);
+
+				long int offset = c->row_ptr[i];
+
+				for (long int t = 0; t < count; t++)
+				{
+					c->col_idx[offset + t] = line_columns[t];
+					c->values[offset + t] = accumulator[line_columns[t]];
+				}
+			}
+		}
+
+		free(marker);
+		free(line_columns);
+		free(accumulator);
+	}
+
+	free(work);
+	free(counts);
+
+	return c;
+}
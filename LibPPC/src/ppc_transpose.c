@@ -0,0 +1,238 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <omp.h>
+
+#include <libppc.h>
+
+/*
+ * Cache-oblivious transposition: the larger side of the block is halved
+ * until it is at most TRANSPOSE_BLOCK x TRANSPOSE_BLOCK, so at some level of
+ * the recursion the source and destination blocks fit in each cache level,
+ * whatever its size. The halves become OpenMP tasks while they have more
+ * than TRANSPOSE_TASK elements.
+ * Splits are kept on multiples of TRANSPOSE_BLOCK, so every leaf except the
+ * ones on the borders is a full block.
+ */
+#define TRANSPOSE_BLOCK 32
+#define TRANSPOSE_TASK (256 * 256)
+
+static long int split_point(long int first, long int last)
+{
+	long int half = (last - first) / 2;
+
+	half = ((half + TRANSPOSE_BLOCK - 1) / TRANSPOSE_BLOCK) * TRANSPOSE_BLOCK;
+
+	return (first + half < last) ? first + half : last;
+}
+
+/*
+ * b[j][i] = a[i][j] for i in [i0, i1) and j in [j0, j1)
+ */
+static void transpose_block(const double *a, long int lda, double *b, long int ldb,
+							long int i0, long int i1, long int j0, long int j1)
+{
+	long int lines = i1 - i0, columns = j1 - j0;
+
+	if (lines <= TRANSPOSE_BLOCK && columns <= TRANSPOSE_BLOCK)
+	{
+		// Leaf: both blocks are in L1, b is written along its lines
+		for (long int j = j0; j < j1; j++)
+			for (long int i = i0; i < i1; i++)
+				M(j, i, ldb, b) = M(i, j, lda, a);
+		return;
+	}
+
+	int task = lines * columns > TRANSPOSE_TASK;
+
+	if (lines >= columns)
+	{
+		long int mid = split_point(i0, i1);
+
+		#pragma omp task if (task)
+		transpose_block(a, lda, b, ldb, i0, mid, j0, j1);
+		transpose_block(a, lda, b, ldb, mid, i1, j0, j1);
+	}
+	else
+	{
+		long int mid = split_point(j0, j1);
+
+		#pragma omp task if (task)
+		transpose_block(a, lda, b, ldb, i0, i1, j0, mid);
+		transpose_block(a, lda, b, ldb, i0, i1, mid, j1);
+	}
+
+	#pragma omp taskwait
+}
+
+/*
+ * Swaps a[i][j] with a[j][i] for i in [i0, i1) and j in [j0, j1), a block
+ * that does not touch the diagonal
+ */
+static void swap_blocks(double *a, long int lda, long int i0, long int i1, long int j0, long int j1)
+{
+	long int lines = i1 - i0, columns = j1 - j0;
+
+	if (lines <= TRANSPOSE_BLOCK && columns <= TRANSPOSE_BLOCK)
+	{
+		for (long int i = i0; i < i1; i++)
+		{
+			for (long int j = j0; j < j1; j++)
+			{
+				double value = M(i, j, lda, a);
+				M(i, j, lda, a) = M(j, i, lda, a);
+				M(j, i, lda, a) = value;
+			}
+		}
+		return;
+	}
+
+	int task = lines * columns > TRANSPOSE_TASK;
+
+	if (lines >= columns)
+	{
+		long int mid = split_point(i0, i1);
+
+		#pragma omp task if (task)
+		swap_blocks(a, lda, i0, mid, j0, j1);
+		swap_blocks(a, lda, mid, i1, j0, j1);
+	}
+	else
+	{
+		long int mid = split_point(j0, j1);
+
+		#pragma omp task if (task)
+		swap_blocks(a, lda, i0, i1, j0, mid);
+		swap_blocks(a, lda, i0, i1, mid, j1);
+	}
+
+	#pragma omp taskwait
+}
+
+/*
+ * In-place transposition of the diagonal block [first, last) x [first, last):
+ * the two diagonal halves are transposed and the off-diagonal quadrants
+ * swapped, three independent pieces of work
+ */
+static void transpose_diagonal(double *a, long int lda, long int first, long int last)
+{
+	long int order = last - first;
+
+	if (order <= TRANSPOSE_BLOCK)
+	{
+		for (long int i = first; i < last; i++)
+		{
+			for (long int j = i + 1; j < last; j++)
+			{
+				double value = M(i, j, lda, a);
+				M(i, j, lda, a) = M(j, i, lda, a);
+				M(j, i, lda, a) = value;
+			}
+		}
+		return;
+	}
+
+	long int mid = split_point(first, last);
+	int task = order * order > TRANSPOSE_TASK;
+
+	#pragma omp task if (task)
+	transpose_diagonal(a, lda, first, mid);
+	#pragma omp task if (task)
+	transpose_diagonal(a, lda, mid, last);
+	swap_blocks(a, lda, first, mid, mid, last);
+
+	#pragma omp taskwait
+}
+
+void ppc_transpose(long int lines, long int columns,
+				   const double *a, long int lda,
+				   double *b, long int ldb)
+{
+	if (lines <= 0 || columns <= 0)
+		return;
+
+	// Called from inside a parallel region the tasks go to the current team
+	#pragma omp parallel if (!omp_in_parallel())
+	{
+		#pragma omp single
+		transpose_block(a, lda, b, ldb, 0, lines, 0, columns);
+	}
+}
+
+void ppc_transpose_inplace(double *a, long int order, long int lda)
+{
+	if (order <= 1)
+		return;
+
+	#pragma omp parallel if (!omp_in_parallel())
+	{
+		#pragma omp single
+		transpose_diagonal(a, lda, 0, order);
+	}
+}
+
+void ppc_row_to_column_major(long int lines, long int columns, const double *a, double *b)
+{
+	// Column-major A (lines x columns) is row-major A^T
+	ppc_transpose(lines, columns, a, columns, b, lines);
+}
+
+void ppc_column_to_row_major(long int lines, long int columns, const double *a, double *b)
+{
+	ppc_transpose(columns, lines, a, lines, b, columns);
+}
+
+/*
+ * Tiled layout: tiles of tile x tile elements, each one contiguous and
+ * row-major, stored tile line by tile line. The tiles on the last line
+ * and column are smaller, without padding: the tile line ti starts at
+ * ti * tile * columns and its tile tj at tj * tile * (lines of tile line ti).
+ * Returns the offset of tile (ti, tj) and its size.
+ */
+static long int tile_offset(long int lines, long int columns, long int tile, long int ti, long int tj,
+							long int *height, long int *width)
+{
+	*height = (lines - ti * tile < tile) ? lines - ti * tile : tile;
+	*width = (columns - tj * tile < tile) ? columns - tj * tile : tile;
+
+	return ti * tile * columns + tj * tile * (*height);
+}
+
+void ppc_row_major_to_tiled(long int lines, long int columns, long int tile, const double *a, double *tiled)
+{
+	long int tile_lines = (lines + tile - 1) / tile;
+	long int tile_columns = (columns + tile - 1) / tile;
+
+	#pragma omp parallel for collapse(2) schedule(static) if (!omp_in_parallel())
+	for (long int ti = 0; ti < tile_lines; ti++)
+	{
+		for (long int tj = 0; tj < tile_columns; tj++)
+		{
+			long int height, width;
+			double *destination = &tiled[tile_offset(lines, columns, tile, ti, tj, &height, &width)];
+
+			for (long int r = 0; r < height; r++)
+				memcpy(&destination[r * width], &M(ti * tile + r, tj * tile, columns, a), sizeof(double) * width);
+		}
+	}
+}
+
+void ppc_tiled_to_row_major(long int lines, long int columns, long int tile, const double *tiled, double *a)
+{
+	long int tile_lines = (lines + tile - 1) / tile;
+	long int tile_columns = (columns + tile - 1) / tile;
+
+	#pragma omp parallel for collapse(2) schedule(static) if (!omp_in_parallel())
+	for (long int ti = 0; ti < tile_lines; ti++)
+	{
+		for (long int tj = 0; tj < tile_columns; tj++)
+		{
+			long int height, width;
+			const double *source = &tiled[tile_offset(lines, columns, tile, ti, tj, &height, &width)];
+
+			for (long int r = 0; r < height; r++)
+				memcpy(&M(ti * tile + r, tj * tile, columns, a), &source[r * width], sizeof(double) * width);
+		}
+	}
+}
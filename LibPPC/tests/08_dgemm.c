@@ -0,0 +1,106 @@
+#include <libppc.h>
+
+#include <stdlib.h>
+
+#include <stdio.h>
+
+#include <math.h>
+
+// C = alpha * A * B + beta * C with a plain triple loop
+static void reference_dgemm(long int m, long int n, long int k, double alpha,
+    const double *a, long int lda, const double *b, long int ldb,
+    double beta, double *c, long int ldc){
+
+    for (long int i = 0; i < m; i++){
+        for (long int j = 0; j < n; j++){
+            double sum = 0.0;
+            for (long int p = 0; p < k; p++){
+                sum += M(i, p, lda, a) * M(p, j, ldb, b);
+            }
+            M(i, j, ldc, c) = alpha * sum + beta * M(i, j, ldc, c);
+        }
+    }
+}
+
+static double max_difference(const double *x, const double *y, long int size){
+
+    double diff = 0.0;
+
+    for (long int i = 0; i < size; i++){
+        if (fabs(x[i] - y[i]) > diff)
+            diff = fabs(x[i] - y[i]);
+    }
+
+    return diff;
+}
+
+int main(){
+
+    /**
+     * Test 1: rectangular sizes that are not multiples of the register
+     * block nor of the cache blocks, with sub-matrixes (lda > k)
+     * */
+    long int m = 301, n = 263, k = 517;
+    long int lda = k + 3, ldb = n + 5, ldc = n + 7;
+
+    double *a = (double*)malloc( sizeof(double) * m * lda );
+    double *b = (double*)malloc( sizeof(double) * k * ldb );
+    double *c = (double*)malloc( sizeof(double) * m * ldc );
+    double *r = (double*)malloc( sizeof(double) * m * ldc );
+
+    for (long int i = 0; i < m * lda; i++)
+        a[ i ] = (double)(rand() % 21 - 10);
+
+    for (long int i = 0; i < k * ldb; i++)
+        b[ i ] = (double)(rand() % 21 - 10);
+
+    for (long int i = 0; i < m * ldc; i++)
+        c[ i ] = r[ i ] = (double)(rand() % 21 - 10);
+
+    ppc_dgemm(m, n, k, 2.0, a, lda, b, ldb, -1.0, c, ldc);
+    reference_dgemm(m, n, k, 2.0, a, lda, b, ldb, -1.0, r, ldc);
+
+    // Small integers: every kernel must give the exact result
+    if ( max_difference(c, r, m * ldc) != 0.0 ){
+        return 1;
+    }
+
+    /**
+     * Test 2: beta = 0 must ignore whatever is in C (even NaN)
+     * */
+    for (long int i = 0; i < m * ldc; i++)
+        c[ i ] = r[ i ] = NAN;
+
+    ppc_dgemm(m, n, k, 1.0, a, lda, b, ldb, 0.0, c, ldc);
+
+    for (long int i = 0; i < m; i++)
+        for (long int j = 0; j < n; j++)
+            M(i, j, ldc, r) = 0.0;
+
+    reference_dgemm(m, n, k, 1.0, a, lda, b, ldb, 0.0, r, ldc);
+
+    for (long int i = 0; i < m; i++)
+        for (long int j = 0; j < n; j++)
+            if ( M(i, j, ldc, c) != M(i, j, ldc, r) )
+                return 2;
+
+    /**
+     * Test 3: k = 0 only scales C
+     * */
+    for (long int i = 0; i < m * ldc; i++)
+        c[ i ] = 1.0;
+
+    ppc_dgemm(m, n, 0, 1.0, a, lda, b, ldb, 3.0, c, ldc);
+
+    for (long int i = 0; i < m; i++)
+        for (long int j = 0; j < n; j++)
+            if ( M(i, j, ldc, c) != 3.0 )
+                return 3;
+
+    free(a);
+    free(b);
+    free(c);
+    free(r);
+
+    return 0;
+}
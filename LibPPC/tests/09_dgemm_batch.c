@@ -0,0 +1,51 @@
+#include <libppc.h>
+
+#include <stdlib.h>
+
+#include <stdio.h>
+
+#define BATCH 200
+#define DIM 37
+
+int main(){
+
+    const double *a_array[ BATCH ];
+    const double *b_array[ BATCH ];
+    double *c_array[ BATCH ];
+    double *expected[ BATCH ];
+
+    for (int t = 0; t < BATCH; t++){
+
+        double *a = (double*)malloc( sizeof(double) * DIM * DIM );
+        double *b = (double*)malloc( sizeof(double) * DIM * DIM );
+
+        for (int i = 0; i < DIM * DIM; i++){
+            a[ i ] = (double)(rand() % 11 - 5);
+            b[ i ] = (double)(rand() % 11 - 5);
+        }
+
+        a_array[ t ] = a;
+        b_array[ t ] = b;
+        c_array[ t ] = (double*)malloc( sizeof(double) * DIM * DIM );
+        expected[ t ] = (double*)malloc( sizeof(double) * DIM * DIM );
+
+        // Every product of the batch must match the single ppc_dgemm call
+        ppc_dgemm(DIM, DIM, DIM, 1.0, a, DIM, b, DIM, 0.0, expected[ t ], DIM);
+    }
+
+    ppc_dgemm_batch(BATCH, DIM, DIM, DIM, 1.0, a_array, DIM, b_array, DIM, 0.0, c_array, DIM);
+
+    for (int t = 0; t < BATCH; t++){
+
+        if ( compare_double_vectors( c_array[ t ], expected[ t ], DIM * DIM ) != 0 ){
+            return 1;
+        }
+
+        free( (double*)a_array[ t ] );
+        free( (double*)b_array[ t ] );
+        free( c_array[ t ] );
+        free( expected[ t ] );
+    }
+
+    return 0;
+}
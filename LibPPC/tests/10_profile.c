@@ -0,0 +1,49 @@
+#include <libppc.h>
+
+#include <stdlib.h>
+
+#include <stdio.h>
+#include <unistd.h>
+
+int main(){
+
+    char filename[] = "/tmp/ppc_profile_XXXXXX";
+    int fd = mkstemp( filename );
+
+    if ( fd < 0 ){
+        return 1;
+    }
+
+    close( fd );
+    setenv( "PPC_PROFILE", filename, 1 );
+
+    // Empty profile: every lookup falls back to the default
+    if ( ppc_profile_get( "gemm_kc", 1000, 256 ) != 256 ){
+        return 1;
+    }
+
+    if ( ppc_profile_set( "gemm_kc", 100, 128 ) != 0 ||
+         ppc_profile_set( "gemm_kc", 2000, 384 ) != 0 ||
+         ppc_profile_set( "gemm_mc", 2000, 144 ) != 0 ){
+        return 1;
+    }
+
+    // Nearest size on a log scale, only among entries with the same key
+    if ( ppc_profile_get( "gemm_kc", 150, 0 ) != 128 ||
+         ppc_profile_get( "gemm_kc", 1000, 0 ) != 384 ||
+         ppc_profile_get( "gemm_mc", 10, 0 ) != 144 ||
+         ppc_profile_get( "gemm_nc", 2000, 4096 ) != 4096 ){
+        return 1;
+    }
+
+    // Setting an existing (key, size) replaces its value
+    ppc_profile_set( "gemm_kc", 2000, 512 );
+
+    if ( ppc_profile_get( "gemm_kc", 2000, 0 ) != 512 ){
+        return 1;
+    }
+
+    unlink( filename );
+
+    return 0;
+}
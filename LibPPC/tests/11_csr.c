@@ -0,0 +1,122 @@
+#include <libppc.h>
+
+#include <stdlib.h>
+
+#include <stdio.h>
+
+#include <omp.h>
+
+int main(){
+
+    /**
+     * Test 1: dense -> CSR -> dense keeps the matrix, with a skewed
+     * pattern (a few full lines, many empty ones)
+     * */
+    long int m = 173, k = 211, n = 97;
+
+    double *a = (double*)malloc( sizeof(double) * m * k );
+    double *b = (double*)malloc( sizeof(double) * k * n );
+    double *c = (double*)malloc( sizeof(double) * m * n );
+
+    for (long int i = 0; i < m; i++)
+        for (long int j = 0; j < k; j++)
+            M(i, j, k, a) = ( i % 17 == 0 || rand() % 20 == 0 ) ? (double)(rand() % 9 + 1) : 0.0;
+
+    for (long int i = 0; i < k * n; i++)
+        b[ i ] = ( rand() % 10 == 0 ) ? (double)(rand() % 9 - 4) : 0.0;
+
+    ppc_csr_t *sa = dense_to_csr_matrix(a, m, k);
+    ppc_csr_t *sb = dense_to_csr_matrix(b, k, n);
+    double *back = csr_to_dense_matrix(sa);
+
+    if ( compare_double_vectors(a, back, m * k) != 0 ){
+        return 1;
+    }
+    free(back);
+
+    /**
+     * Test 2: SpMV against the dense product
+     * */
+    double *x = (double*)malloc( sizeof(double) * k );
+    double *y = (double*)malloc( sizeof(double) * m );
+
+    for (long int j = 0; j < k; j++)
+        x[ j ] = (double)(rand() % 7 - 3);
+
+    ppc_csr_spmv(sa, x, y);
+
+    for (long int i = 0; i < m; i++){
+        double sum = 0.0;
+        for (long int j = 0; j < k; j++)
+            sum += M(i, j, k, a) * x[ j ];
+        if ( y[ i ] != sum )
+            return 2;
+    }
+
+    /**
+     * Test 3: SpGEMM against ppc_dgemm(), with sorted columns
+     * */
+    ppc_csr_t *sc = ppc_csr_spgemm(sa, sb);
+
+    ppc_dgemm(m, n, k, 1.0, a, k, b, n, 0.0, c, n);
+    back = csr_to_dense_matrix(sc);
+
+    if ( compare_double_vectors(c, back, m * n) != 0 ){
+        return 3;
+    }
+
+    for (long int i = 0; i < m; i++)
+        for (long int p = sc->row_ptr[ i ] + 1; p < sc->row_ptr[ i + 1 ]; p++)
+            if ( sc->col_idx[ p - 1 ] >= sc->col_idx[ p ] )
+                return 3;
+
+    /**
+     * Test 4: transposing twice (CSR -> CSC -> CSR) and save/load
+     * */
+    ppc_csr_t *t = transpose_csr_matrix(sa);
+    ppc_csr_t *tt = transpose_csr_matrix(t);
+
+    save_csr_matrix(tt, "teste11.csr");
+    ppc_csr_t *loaded = load_csr_matrix("teste11.csr");
+    remove("teste11.csr");
+
+    if ( loaded == NULL || loaded->nnz != sa->nnz || loaded->lines != m || loaded->columns != k ){
+        return 4;
+    }
+
+    for (long int p = 0; p < sa->nnz; p++)
+        if ( loaded->col_idx[ p ] != sa->col_idx[ p ] || loaded->values[ p ] != sa->values[ p ] )
+            return 4;
+
+    /**
+     * Test 5: the generated matrix does not depend on the number of threads
+     * */
+    ppc_csr_t *g1 = generate_random_csr_matrix(500, 700, 0.02, 42);
+    omp_set_num_threads(3);
+    ppc_csr_t *g2 = generate_random_csr_matrix(500, 700, 0.02, 42);
+
+    if ( g1->nnz != g2->nnz || g1->nnz == 0 ){
+        return 5;
+    }
+
+    for (long int p = 0; p < g1->nnz; p++)
+        if ( g1->col_idx[ p ] != g2->col_idx[ p ] || g1->values[ p ] != g2->values[ p ] )
+            return 5;
+
+    free_csr_matrix(sa);
+    free_csr_matrix(sb);
+    free_csr_matrix(sc);
+    free_csr_matrix(t);
+    free_csr_matrix(tt);
+    free_csr_matrix(loaded);
+    free_csr_matrix(g1);
+    free_csr_matrix(g2);
+    free(a);
+    free(b);
+    free(c);
+    free(x);
+    free(y);
+    free(back);
+
+    return 0;
+}
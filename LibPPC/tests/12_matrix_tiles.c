@@ -0,0 +1,77 @@
+#include <libppc.h>
+
+#include <stdlib.h>
+
+#include <stdio.h>
+
+int main(){
+
+    long int lines = 37, columns = 53;
+
+    // Same values as generate_random_double_matrix() with the same seed
+    srand( 7 );
+    double *matrix = generate_random_double_matrix( lines, columns );
+
+    srand( 7 );
+    if ( generate_random_double_matrix_file( lines, columns, "teste12.dat" ) != 0 ){
+        return 1;
+    }
+
+    double *loaded = load_double_matrix( "teste12.dat", lines, columns );
+
+    if ( compare_double_vectors( matrix, loaded, lines * columns ) != 0 ){
+        return 1;
+    }
+
+    /**
+     * Reads a tile into a buffer with a larger leading dimension, writes it
+     * back shifted to another position and checks the file
+     * */
+    long int ld = 16;
+    double tile[ 11 * 16 ];
+
+    FILE *fd = fopen( "teste12.dat", "r+b" );
+
+    if ( read_double_matrix_tile( fd, columns, 5, 7, 11, 13, tile, ld ) != 0 ){
+        return 2;
+    }
+
+    for (long int i = 0; i < 11; i++)
+        for (long int j = 0; j < 13; j++)
+            if ( M(i, j, ld, tile) != M(5 + i, 7 + j, columns, matrix) )
+                return 2;
+
+    if ( write_double_matrix_tile( fd, columns, 20, 30, 11, 13, tile, ld ) != 0 ){
+        return 3;
+    }
+
+    // Whole lines are one contiguous read
+    double *lines_tile = (double*)malloc( sizeof(double) * 4 * columns );
+
+    if ( read_double_matrix_tile( fd, columns, 33, 0, 4, columns, lines_tile, columns ) != 0 ){
+        return 4;
+    }
+
+    fclose( fd );
+
+    for (long int i = 0; i < 11; i++)
+        for (long int j = 0; j < 13; j++)
+            M(20 + i, 30 + j, columns, matrix) = M(5 + i, 7 + j, columns, matrix);
+
+    free( loaded );
+    loaded = load_double_matrix( "teste12.dat", lines, columns );
+
+    if ( compare_double_vectors( matrix, loaded, lines * columns ) != 0 ){
+        return 3;
+    }
+
+    if ( compare_double_vectors( &M(33, 0, columns, matrix), lines_tile, 4 * columns ) != 0 ){
+        return 4;
+    }
+
+    free( matrix );
+    free( loaded );
+    free( lines_tile );
+
+    return 0;
+}
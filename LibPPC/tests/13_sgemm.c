@@ -0,0 +1,75 @@
+#include <libppc.h>
+
+#include <stdlib.h>
+
+#include <stdio.h>
+
+int main(){
+
+    /**
+     * Test 1: rectangular sub-matrixes, small integers, so float is exact
+     * */
+    long int m = 203, n = 171, k = 419;
+    long int lda = k + 1, ldb = n + 3, ldc = n + 2;
+
+    float *a = (float*)malloc( sizeof(float) * m * lda );
+    float *b = (float*)malloc( sizeof(float) * k * ldb );
+    float *c = (float*)malloc( sizeof(float) * m * ldc );
+    double *ad = (double*)malloc( sizeof(double) * m * lda );
+    double *bd = (double*)malloc( sizeof(double) * k * ldb );
+    double *cd = (double*)malloc( sizeof(double) * m * ldc );
+    double *r = (double*)malloc( sizeof(double) * m * ldc );
+
+    for (long int i = 0; i < m * lda; i++)
+        ad[ i ] = a[ i ] = (float)(rand() % 21 - 10);
+
+    for (long int i = 0; i < k * ldb; i++)
+        bd[ i ] = b[ i ] = (float)(rand() % 21 - 10);
+
+    for (long int i = 0; i < m * ldc; i++){
+        c[ i ] = (float)(rand() % 21 - 10);
+        cd[ i ] = r[ i ] = c[ i ];
+    }
+
+    ppc_sgemm(m, n, k, 2.0f, a, lda, b, ldb, -1.0f, c, ldc);
+    ppc_dgemm(m, n, k, 2.0, ad, lda, bd, ldb, -1.0, r, ldc);
+
+    for (long int i = 0; i < m; i++)
+        for (long int j = 0; j < n; j++)
+            if ( (double)M(i, j, ldc, c) != M(i, j, ldc, r) )
+                return 1;
+
+    /**
+     * Test 2: the mixed version gives the double result from float inputs
+     * */
+    ppc_dsgemm(m, n, k, 2.0, a, lda, b, ldb, -1.0, cd, ldc);
+
+    for (long int i = 0; i < m; i++)
+        for (long int j = 0; j < n; j++)
+            if ( M(i, j, ldc, cd) != M(i, j, ldc, r) )
+                return 2;
+
+    /**
+     * Test 3: float matrix files
+     * */
+    float *g = generate_random_float_matrix( 13, 17 );
+
+    save_float_matrix( g, 13, 17, "teste13.dat" );
+    float *loaded = load_float_matrix( "teste13.dat", 13, 17 );
+
+    for (long int i = 0; i < 13 * 17; i++)
+        if ( loaded == NULL || loaded[ i ] != g[ i ] )
+            return 3;
+
+    free(a);
+    free(b);
+    free(c);
+    free(ad);
+    free(bd);
+    free(cd);
+    free(r);
+    free(g);
+    free(loaded);
+
+    return 0;
+}
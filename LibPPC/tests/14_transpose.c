@@ -0,0 +1,104 @@
+#include <libppc.h>
+
+#include <stdlib.h>
+
+#include <stdio.h>
+
+int main(){
+
+    // Sizes that are not multiples of the blocks, so the border leaves run
+    long int lines = 301, columns = 517;
+
+    srand( 14 );
+    double *matrix = generate_random_double_matrix( lines, columns );
+    double *result = (double*)malloc( sizeof(double) * lines * columns );
+    double *back = (double*)malloc( sizeof(double) * lines * columns );
+
+    ppc_transpose( lines, columns, matrix, columns, result, lines );
+
+    for (long int i = 0; i < lines; i++)
+        for (long int j = 0; j < columns; j++)
+            if ( M(j, i, lines, result) != M(i, j, columns, matrix) )
+                return 1;
+
+    /**
+     * A 40x50 sub-matrix with leading dimensions larger than its sides
+     * */
+    long int ldb = 64;
+    double *sub = (double*)malloc( sizeof(double) * 50 * ldb );
+
+    ppc_transpose( 40, 50, &M(3, 5, columns, matrix), columns, sub, ldb );
+
+    for (long int i = 0; i < 40; i++)
+        for (long int j = 0; j < 50; j++)
+            if ( M(j, i, ldb, sub) != M(3 + i, 5 + j, columns, matrix) )
+                return 2;
+
+    // In place, on the square top-left corner with the original leading dimension
+    long int order = 289;
+    double *square = (double*)malloc( sizeof(double) * lines * columns );
+
+    for (long int i = 0; i < lines * columns; i++)
+        square[i] = matrix[i];
+
+    ppc_transpose_inplace( square, order, columns );
+
+    for (long int i = 0; i < order; i++)
+        for (long int j = 0; j < order; j++)
+            if ( M(i, j, columns, square) != M(j, i, columns, matrix) )
+                return 3;
+
+    // Columns outside the square are not touched
+    for (long int i = 0; i < lines; i++)
+        for (long int j = (i < order) ? order : 0; j < columns; j++)
+            if ( M(i, j, columns, square) != M(i, j, columns, matrix) )
+                return 3;
+
+    // Column-major A is the transposition stored with ld = lines
+    ppc_row_to_column_major( lines, columns, matrix, result );
+
+    for (long int i = 0; i < lines; i++)
+        for (long int j = 0; j < columns; j++)
+            if ( result[j * lines + i] != M(i, j, columns, matrix) )
+                return 4;
+
+    ppc_column_to_row_major( lines, columns, result, back );
+
+    if ( compare_double_vectors( matrix, back, lines * columns ) != 0 ){
+        return 4;
+    }
+
+    /**
+     * Tiled layout: every tile contiguous, the border tiles smaller and
+     * without padding
+     * */
+    long int tile = 64;
+
+    ppc_row_major_to_tiled( lines, columns, tile, matrix, result );
+
+    // Tile (4, 8) is the last one of both directions: 45x5 elements
+    long int offset = 4 * tile * columns + 8 * tile * 45;
+
+    if ( offset + 45 * 5 != lines * columns ){
+        return 5;
+    }
+
+    for (long int r = 0; r < 45; r++)
+        for (long int c = 0; c < 5; c++)
+            if ( result[offset + r * 5 + c] != M(256 + r, 512 + c, columns, matrix) )
+                return 5;
+
+    ppc_tiled_to_row_major( lines, columns, tile, result, back );
+
+    if ( compare_double_vectors( matrix, back, lines * columns ) != 0 ){
+        return 6;
+    }
+
+    free( matrix );
+    free( result );
+    free( back );
+    free( sub );
+    free( square );
+
+    return 0;
+}
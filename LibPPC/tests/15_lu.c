@@ -0,0 +1,147 @@
+#include <libppc.h>
+
+#include <stdlib.h>
+
+#include <stdio.h>
+
+#include <math.h>
+
+/**
+ * Rebuilds L * U from a factored lines x columns matrix, applies the swaps
+ * to the original and returns max|P * A - L * U| / max|A|
+ * */
+static double lu_residual(long int lines, long int columns, const double *original,
+    const double *lu, long int lda, const int *ipiv){
+
+    long int steps = (lines < columns) ? lines : columns;
+    double *pa = (double*)malloc( sizeof(double) * lines * columns );
+    double largest = 0.0, residual = 0.0;
+
+    for (long int i = 0; i < lines; i++)
+        for (long int j = 0; j < columns; j++)
+            M(i, j, columns, pa) = M(i, j, lda, original);
+
+    ppc_dlaswp( columns, pa, columns, 0, steps, ipiv );
+
+    for (long int i = 0; i < lines; i++){
+        for (long int j = 0; j < columns; j++){
+            double sum = 0.0;
+            for (long int p = 0; p <= i && p <= j && p < steps; p++){
+                double l = (p == i) ? 1.0 : M(i, p, lda, lu);
+                sum += l * M(p, j, lda, lu);
+            }
+            if (fabs(M(i, j, lda, original)) > largest)
+                largest = fabs(M(i, j, lda, original));
+            if (fabs(M(i, j, columns, pa) - sum) > residual)
+                residual = fabs(M(i, j, columns, pa) - sum);
+        }
+    }
+
+    free( pa );
+
+    return residual / largest;
+}
+
+// tile 0 checks ppc_dgetrf(), others ppc_dgetrf_tiled() with that tile
+static int check(long int lines, long int columns, long int lda, long int tile){
+
+    long int steps = (lines < columns) ? lines : columns;
+    double *original = generate_random_double_matrix( lines, lda );
+    double *lu = (double*)malloc( sizeof(double) * lines * lda );
+    int *ipiv = (int*)malloc( sizeof(int) * steps );
+
+    for (long int i = 0; i < lines * lda; i++)
+        lu[i] = original[i];
+
+    int info = (tile > 0) ? ppc_dgetrf_tiled( lines, columns, lu, lda, ipiv, tile )
+                          : ppc_dgetrf( lines, columns, lu, lda, ipiv );
+
+    if ( info != 0 ){
+        return 1;
+    }
+
+    // Partial pivoting keeps every multiplier at most 1
+    for (long int i = 0; i < lines; i++)
+        for (long int j = 0; j < i && j < steps; j++)
+            if ( fabs(M(i, j, lda, lu)) > 1.0 )
+                return 1;
+
+    int failed = lu_residual( lines, columns, original, lu, lda, ipiv ) > 1e-12;
+
+    // Columns past lda are not touched
+    for (long int i = 0; i < lines; i++)
+        for (long int j = columns; j < lda; j++)
+            if ( M(i, j, lda, lu) != M(i, j, lda, original) )
+                failed = 1;
+
+    free( original );
+    free( lu );
+    free( ipiv );
+
+    return failed;
+}
+
+int main(){
+
+    srand( 15 );
+
+    // Square with several panels, wide and tall, and a sub-matrix (lda > columns)
+    if ( check( 300, 300, 300, 0 ) != 0 ){
+        return 1;
+    }
+
+    if ( check( 150, 263, 263, 0 ) != 0 ){
+        return 2;
+    }
+
+    if ( check( 263, 150, 150, 0 ) != 0 ){
+        return 3;
+    }
+
+    if ( check( 200, 200, 211, 0 ) != 0 ){
+        return 4;
+    }
+
+    // Tiled, with tiles that do not divide the sizes
+    if ( check( 300, 300, 300, 64 ) != 0 ){
+        return 6;
+    }
+
+    if ( check( 150, 263, 263, 48 ) != 0 ){
+        return 7;
+    }
+
+    if ( check( 263, 150, 157, 40 ) != 0 ){
+        return 8;
+    }
+
+    /**
+     * A zero column makes the matrix singular: the factorization reports
+     * the first zero pivot (1-based) and still completes
+     * */
+    long int order = 40;
+    double *a = generate_random_double_matrix( order, order );
+    int ipiv[40];
+
+    for (long int i = 0; i < order; i++)
+        M(i, 9, order, a) = 0.0;
+
+    double *b = (double*)malloc( sizeof(double) * order * order );
+
+    for (long int i = 0; i < order * order; i++)
+        b[i] = a[i];
+
+    if ( ppc_dgetrf( order, order, a, order, ipiv ) != 10 ){
+        return 5;
+    }
+
+    if ( ppc_dgetrf_tiled( order, order, b, order, ipiv, 16 ) != 10 ){
+        return 5;
+    }
+
+    free( b );
+
+    free( a );
+
+    return 0;
+}
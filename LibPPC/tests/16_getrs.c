@@ -0,0 +1,81 @@
+#include <libppc.h>
+
+#include <stdlib.h>
+
+#include <stdio.h>
+
+#include <math.h>
+
+/**
+ * Factors a random order x order matrix, solves nrhs right-hand sides
+ * stored with leading dimension ldb and returns max|A * X - B| / max|B|
+ * */
+static double solve_residual(long int order, long int nrhs, long int ldb){
+
+    double *a = generate_random_double_matrix( order, order );
+    double *lu = (double*)malloc( sizeof(double) * order * order );
+    double *b = generate_random_double_matrix( order, ldb );
+    double *x = (double*)malloc( sizeof(double) * order * ldb );
+    int *ipiv = (int*)malloc( sizeof(int) * order );
+
+    for (long int i = 0; i < order * order; i++)
+        lu[i] = a[i];
+
+    for (long int i = 0; i < order * ldb; i++)
+        x[i] = b[i];
+
+    if ( ppc_dgetrf( order, order, lu, order, ipiv ) != 0 ){
+        return 1.0;
+    }
+
+    ppc_dgetrs( order, nrhs, lu, order, ipiv, x, ldb );
+
+    double largest = 0.0, residual = 0.0;
+
+    for (long int i = 0; i < order; i++){
+        for (long int j = 0; j < nrhs; j++){
+            double sum = 0.0;
+            for (long int k = 0; k < order; k++)
+                sum += M(i, k, order, a) * M(k, j, ldb, x);
+            if (fabs(M(i, j, ldb, b)) > largest)
+                largest = fabs(M(i, j, ldb, b));
+            if (fabs(sum - M(i, j, ldb, b)) > residual)
+                residual = fabs(sum - M(i, j, ldb, b));
+        }
+
+        // Columns past nrhs are not touched
+        for (long int j = nrhs; j < ldb; j++)
+            if ( M(i, j, ldb, x) != M(i, j, ldb, b) )
+                return 1.0;
+    }
+
+    free( a );
+    free( lu );
+    free( b );
+    free( x );
+    free( ipiv );
+
+    return residual / largest;
+}
+
+int main(){
+
+    srand( 16 );
+
+    // One right-hand side (row updates) and several blocks of lines
+    if ( solve_residual( 300, 1, 1 ) > 1e-9 ){
+        return 1;
+    }
+
+    // Many right-hand sides (GEMM updates), on a sub-matrix of B
+    if ( solve_residual( 300, 37, 41 ) > 1e-9 ){
+        return 2;
+    }
+
+    // Smaller than one block
+    if ( solve_residual( 50, 3, 3 ) > 1e-9 ){
+        return 3;
+    }
+
+    return 0;
+}
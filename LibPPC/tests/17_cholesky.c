@@ -0,0 +1,101 @@
+#include <libppc.h>
+
+#include <stdlib.h>
+
+#include <stdio.h>
+
+#include <math.h>
+
+/**
+ * Factors the SPD matrix a (order x order) stored with leading dimension
+ * lda, checks max|A - L * L^T| / max|A| and that the upper triangle and the
+ * columns past order are not touched
+ * */
+static int check(long int order, long int lda){
+
+    double *spd = generate_random_spd_matrix( order );
+    double *a = (double*)malloc( sizeof(double) * order * lda );
+    double *l = (double*)malloc( sizeof(double) * order * lda );
+
+    for (long int i = 0; i < order; i++){
+        for (long int j = 0; j < lda; j++){
+            M(i, j, lda, a) = (j < order) ? M(i, j, order, spd) : -1.0;
+            M(i, j, lda, l) = M(i, j, lda, a);
+        }
+    }
+
+    // Symmetric and strictly diagonally dominant
+    for (long int i = 0; i < order; i++){
+        double sum = 0.0;
+        for (long int j = 0; j < order; j++){
+            if ( M(i, j, order, spd) != M(j, i, order, spd) )
+                return 1;
+            if ( j != i )
+                sum += fabs( M(i, j, order, spd) );
+        }
+        if ( M(i, i, order, spd) <= sum )
+            return 1;
+    }
+
+    if ( ppc_dpotrf( order, l, lda ) != 0 ){
+        return 1;
+    }
+
+    double largest = 0.0, residual = 0.0;
+
+    for (long int i = 0; i < order; i++){
+        for (long int j = 0; j <= i; j++){
+            double sum = 0.0;
+            for (long int p = 0; p <= j; p++)
+                sum += M(i, p, lda, l) * M(j, p, lda, l);
+            if (fabs(M(i, j, lda, a)) > largest)
+                largest = fabs(M(i, j, lda, a));
+            if (fabs(M(i, j, lda, a) - sum) > residual)
+                residual = fabs(M(i, j, lda, a) - sum);
+        }
+        for (long int j = i + 1; j < lda; j++)
+            if ( M(i, j, lda, l) != M(i, j, lda, a) )
+                return 1;
+    }
+
+    free( spd );
+    free( a );
+    free( l );
+
+    return residual / largest > 1e-13;
+}
+
+int main(){
+
+    srand( 17 );
+
+    // Several blocks, a sub-matrix, and less than one block
+    if ( check( 300, 300 ) != 0 ){
+        return 1;
+    }
+
+    if ( check( 263, 270 ) != 0 ){
+        return 2;
+    }
+
+    if ( check( 50, 50 ) != 0 ){
+        return 3;
+    }
+
+    /**
+     * A negative diagonal element past the first block: not positive
+     * definite, reported as the order of the first minor that fails
+     * */
+    long int order = 200;
+    double *a = generate_random_spd_matrix( order );
+
+    M(150, 150, order, a) = -1.0;
+
+    if ( ppc_dpotrf( order, a, order ) != 151 ){
+        return 4;
+    }
+
+    free( a );
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include <libppc.h>
+
+#include <stdlib.h>
+
+#include <stdio.h>
+
+#include <math.h>
+
+#include <float.h>
+
+// max|A * X - B| / (max line sum of |A| * max|X| + max|B|), all columns
+static double backward_error(long int order, long int nrhs, const double *a,
+    const double *x, const double *b){
+
+    double norm_a = 0.0, largest_r = 0.0, largest_x = 0.0, largest_b = 0.0;
+
+    for (long int i = 0; i < order; i++){
+        double line = 0.0;
+        for (long int k = 0; k < order; k++)
+            line += fabs(M(i, k, order, a));
+        if (line > norm_a)
+            norm_a = line;
+
+        for (long int j = 0; j < nrhs; j++){
+            double sum = 0.0;
+            for (long int k = 0; k < order; k++)
+                sum += M(i, k, order, a) * M(k, j, nrhs, x);
+            largest_r = fmax(largest_r, fabs(sum - M(i, j, nrhs, b)));
+            largest_x = fmax(largest_x, fabs(M(i, j, nrhs, x)));
+            largest_b = fmax(largest_b, fabs(M(i, j, nrhs, b)));
+        }
+    }
+
+    return largest_r / (norm_a * largest_x + largest_b);
+}
+
+int main(){
+
+    srand( 18 );
+
+    /**
+     * Float LU: P * A = L * U up to float rounding
+     * */
+    long int order = 300;
+    double *a = generate_random_double_matrix( order, order );
+    float *lu = (float*)malloc( sizeof(float) * order * order );
+    int *ipiv = (int*)malloc( sizeof(int) * order );
+
+    for (long int i = 0; i < order * order; i++)
+        lu[i] = (float)a[i];
+
+    if ( ppc_sgetrf( order, order, lu, order, ipiv ) != 0 ){
+        return 1;
+    }
+
+    float *pa = (float*)malloc( sizeof(float) * order * order );
+
+    for (long int i = 0; i < order * order; i++)
+        pa[i] = (float)a[i];
+
+    ppc_slaswp( order, pa, order, 0, order, ipiv );
+
+    for (long int i = 0; i < order; i++){
+        for (long int j = 0; j < order; j++){
+            double sum = 0.0;
+            for (long int p = 0; p <= i && p <= j; p++)
+                sum += ((p == i) ? 1.0 : M(i, p, order, lu)) * M(p, j, order, lu);
+            if ( fabs(sum - M(i, j, order, pa)) > 1e-4 * order * order )
+                return 1;
+        }
+    }
+
+    /**
+     * Mixed precision solve: refined to double accuracy, one and several
+     * right-hand sides
+     * */
+    for (long int nrhs = 1; nrhs <= 9; nrhs += 8){
+        double *b = generate_random_double_matrix( order, nrhs );
+        double *x = (double*)malloc( sizeof(double) * order * nrhs );
+        int iterations;
+
+        if ( ppc_dsgesv( order, nrhs, a, order, b, nrhs, x, nrhs, &iterations ) != 0 ){
+            return 2;
+        }
+
+        if ( iterations < 0 || backward_error( order, nrhs, a, x, b ) > 10 * DBL_EPSILON ){
+            return 2;
+        }
+
+        free( b );
+        free( x );
+    }
+
+    /**
+     * Hilbert matrix of order 12 (condition number ~1e16): the float
+     * factorization cannot be refined, the solve falls back to double
+     * */
+    long int h = 12;
+    double hilbert[12 * 12], hb[12], hx[12];
+    int iterations;
+
+    for (long int i = 0; i < h; i++){
+        hb[i] = 1.0;
+        for (long int j = 0; j < h; j++)
+            M(i, j, h, hilbert) = 1.0 / (i + j + 1);
+    }
+
+    if ( ppc_dsgesv( h, 1, hilbert, h, hb, 1, hx, 1, &iterations ) != 0 || iterations != -1 ){
+        return 3;
+    }
+
+    if ( backward_error( h, 1, hilbert, hx, hb ) > 10 * DBL_EPSILON ){
+        return 3;
+    }
+
+    free( a );
+    free( lu );
+    free( pa );
+    free( ipiv );
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+#include <libppc.h>
+
+#include <stdlib.h>
+
+#include <stdio.h>
+
+#include <math.h>
+
+/**
+ * Solves a random band system (not diagonally dominant, so it pivots) and
+ * returns the backward error max|A * x - b| / (||A||_inf max|x|), computed
+ * with the dense matrix
+ * */
+static double band_residual(long int order, long int kl, long int ku){
+
+    ppc_band_t *band = alloc_band_matrix( order, kl, ku );
+
+    for (long int i = 0; i < order; i++)
+        for (long int j = (i - kl > 0) ? i - kl : 0; j <= i + ku && j < order; j++)
+            BAND(band, i, j) = rand() % 19 - 9;
+
+    double *a = band_to_dense_matrix( band );
+    double *b = (double*)malloc( sizeof(double) * order );
+    double *x = (double*)malloc( sizeof(double) * order );
+    int *ipiv = (int*)malloc( sizeof(int) * order );
+    double norm = 0.0, largest = 0.0, residual = 0.0;
+
+    for (long int i = 0; i < order; i++){
+        b[i] = rand() % 100 - 50;
+        x[i] = b[i];
+    }
+
+    if ( ppc_band_getrf( band, ipiv ) != 0 ){
+        return 1.0;
+    }
+
+    ppc_band_getrs( band, ipiv, x );
+
+    for (long int i = 0; i < order; i++){
+        double sum = 0.0, line = 0.0;
+        for (long int j = 0; j < order; j++){
+            sum += M(i, j, order, a) * x[j];
+            line += fabs(M(i, j, order, a));
+        }
+        if (fabs(sum - b[i]) > residual)
+            residual = fabs(sum - b[i]);
+        if (line > norm)
+            norm = line;
+        if (fabs(x[i]) > largest)
+            largest = fabs(x[i]);
+    }
+
+    free_band_matrix( band );
+    free( a );
+    free( b );
+    free( x );
+    free( ipiv );
+
+    return residual / (norm * largest);
+}
+
+/**
+ * Solves a random diagonally dominant tridiagonal system and returns
+ * max|x - 1|, with b = A * 1
+ * */
+static double tridiagonal_error(long int order){
+
+    double *sub = (double*)malloc( sizeof(double) * order );
+    double *diagonal = (double*)malloc( sizeof(double) * order );
+    double *super = (double*)malloc( sizeof(double) * order );
+    double *x = (double*)malloc( sizeof(double) * order );
+    double error = 0.0;
+
+    for (long int i = 0; i < order; i++){
+        sub[i] = (i > 0) ? rand() % 10 + 1 : 0.0;
+        super[i] = (i < order - 1) ? -(rand() % 10 + 1) : 0.0;
+        diagonal[i] = fabs(sub[i]) + fabs(super[i]) + 1 + rand() % 5;
+        x[i] = sub[i] + diagonal[i] + super[i];
+    }
+
+    if ( ppc_tridiagonal_solve( order, sub, diagonal, super, x ) != 0 ){
+        return 1.0;
+    }
+
+    for (long int i = 0; i < order; i++)
+        if (fabs(x[i] - 1.0) > error)
+            error = fabs(x[i] - 1.0);
+
+    free( sub );
+    free( diagonal );
+    free( super );
+    free( x );
+
+    return error;
+}
+
+int main(){
+
+    srand( 19 );
+
+    /*
+     * Test 1: banded LU with pivoting, narrow and wide bands
+     * */
+    if ( band_residual( 200, 1, 1 ) > 1e-13 ){
+        return 1;
+    }
+
+    if ( band_residual( 300, 7, 3 ) > 1e-13 ){
+        return 2;
+    }
+
+    if ( band_residual( 50, 60, 60 ) > 1e-13 ){
+        return 3;
+    }
+
+    /*
+     * Test 2: save/load and the product with the band
+     * */
+    ppc_band_t *band = generate_random_band_matrix( 1000, 3, 5, 19 );
+    save_band_matrix( band, "teste19.band" );
+    ppc_band_t *loaded = load_band_matrix( "teste19.band" );
+    remove( "teste19.band" );
+
+    if ( loaded == NULL || loaded->order != 1000 || loaded->kl != 3 || loaded->ku != 5 ){
+        return 4;
+    }
+
+    double *ones = (double*)malloc( sizeof(double) * 1000 );
+    double *y = (double*)malloc( sizeof(double) * 1000 );
+    int *ipiv = (int*)malloc( sizeof(int) * 1000 );
+
+    for (long int i = 0; i < 1000; i++)
+        ones[i] = 1.0;
+
+    ppc_band_gbmv( loaded, ones, y );
+    ppc_band_getrf( loaded, ipiv );
+    ppc_band_getrs( loaded, ipiv, y );
+
+    for (long int i = 0; i < 1000; i++)
+        if (fabs(y[i] - 1.0) > 1e-12)
+            return 5;
+
+    free_band_matrix( band );
+    free_band_matrix( loaded );
+    free( ones );
+    free( y );
+    free( ipiv );
+
+    /*
+     * Test 3: tridiagonal solver, one block and many blocks
+     * */
+    if ( tridiagonal_error( 10 ) > 1e-12 ){
+        return 6;
+    }
+
+    if ( tridiagonal_error( 100000 ) > 1e-12 ){
+        return 7;
+    }
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include <libppc.h>
+
+#include <stdlib.h>
+
+#include <stdio.h>
+
+#include <string.h>
+
+#include <math.h>
+
+/**
+ * Random lines x columns matrix with values between -1 and 1
+ * */
+static double *random_matrix(long int lines, long int columns){
+
+    double *a = (double*)malloc( sizeof(double) * lines * columns );
+
+    for (long int i = 0; i < lines * columns; i++)
+        a[i] = 2.0 * rand() / RAND_MAX - 1.0;
+
+    return a;
+}
+
+/**
+ * max|R^T R - A^T A| / max|A^T A|: R is the R of A whatever Q is (only the
+ * upper triangle of r is read)
+ * */
+static double gram_error(long int lines, long int columns, const double *a, const double *r, long int ldr){
+
+    double largest = 0.0, error = 0.0;
+
+    for (long int i = 0; i < columns; i++){
+        for (long int j = 0; j < columns; j++){
+            double ata = 0.0, rtr = 0.0;
+            for (long int k = 0; k < lines; k++)
+                ata += M(k, i, columns, a) * M(k, j, columns, a);
+            for (long int k = 0; k <= i && k <= j; k++)
+                rtr += M(k, i, ldr, r) * M(k, j, ldr, r);
+            if (fabs(ata) > largest)
+                largest = fabs(ata);
+            if (fabs(ata - rtr) > error)
+                error = fabs(ata - rtr);
+        }
+    }
+
+    return error / largest;
+}
+
+int main(){
+
+    srand( 20 );
+
+    /*
+     * Test 1: Q^T A is R, zero below the diagonal, on several panels
+     * */
+    long int m = 300, n = 70;
+    double *a = random_matrix( m, n );
+    double *qr = (double*)malloc( sizeof(double) * m * n );
+    double *qta = (double*)malloc( sizeof(double) * m * n );
+    double *tau = (double*)malloc( sizeof(double) * n );
+
+    memcpy( qr, a, sizeof(double) * m * n );
+    memcpy( qta, a, sizeof(double) * m * n );
+
+    if ( ppc_dgeqrf( m, n, qr, n, tau ) != 0 ){
+        return 1;
+    }
+
+    ppc_dormqr( m, n, n, qr, n, tau, qta, n );
+
+    for (long int i = 0; i < m; i++)
+        for (long int j = 0; j < n; j++)
+            if ( fabs( M(i, j, n, qta) - ((j >= i) ? M(i, j, n, qr) : 0.0) ) > 1e-12 )
+                return 2;
+
+    if ( gram_error( m, n, a, qr, n ) > 1e-13 ){
+        return 3;
+    }
+
+    /*
+     * Test 2: least squares, with the normal equations A^T (A x - b) = 0
+     * */
+    double *b = random_matrix( m, 1 );
+    double *x = (double*)malloc( sizeof(double) * m );
+
+    memcpy( qr, a, sizeof(double) * m * n );
+    memcpy( x, b, sizeof(double) * m );
+
+    if ( ppc_dgels( m, n, 1, qr, n, x, 1 ) != 0 ){
+        return 4;
+    }
+
+    for (long int j = 0; j < n; j++){
+        double normal = 0.0;
+        for (long int i = 0; i < m; i++){
+            double residual = -b[i];
+            for (long int k = 0; k < n; k++)
+                residual += M(i, k, n, a) * x[k];
+            normal += M(i, j, n, a) * residual;
+        }
+        if ( fabs( normal ) > 1e-11 )
+            return 5;
+    }
+
+    /*
+     * Test 3: TSQR, many leaves, against ppc_dgeqrf()
+     * */
+    long int tall = 20000, skinny = 12;
+    double *t = random_matrix( tall, skinny );
+    double *work = (double*)malloc( sizeof(double) * tall * skinny );
+    double *r = (double*)malloc( sizeof(double) * skinny * skinny );
+    double *tau_tall = (double*)malloc( sizeof(double) * skinny );
+
+    memcpy( work, t, sizeof(double) * tall * skinny );
+
+    if ( ppc_dtsqr( tall, skinny, work, skinny, r, skinny ) != 0 ){
+        return 6;
+    }
+
+    if ( gram_error( tall, skinny, t, r, skinny ) > 1e-13 ){
+        return 7;
+    }
+
+    memcpy( work, t, sizeof(double) * tall * skinny );
+    ppc_dgeqrf( tall, skinny, work, skinny, tau_tall );
+
+    for (long int i = 0; i < skinny; i++)
+        for (long int j = i; j < skinny; j++)
+            if ( fabs( fabs( M(i, j, skinny, r) ) - fabs( M(i, j, skinny, work) ) ) > 1e-10 )
+                return 8;
+
+    free( a );
+    free( qr );
+    free( qta );
+    free( tau );
+    free( b );
+    free( x );
+    free( t );
+    free( work );
+    free( r );
+    free( tau_tall );
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include <libppc.h>
+
+#include <stdlib.h>
+
+#include <stdio.h>
+
+#include <math.h>
+
+int main(){
+
+    srand( 21 );
+
+    /*
+     * Test 1: determinant of a small matrix with a known value
+     * */
+    double small[9] = { 0, 2, 1,
+                        3, 1, 4,
+                        1, 0, 2 };
+
+    // 0 * (2 - 0) - 2 * (6 - 4) + 1 * (0 - 1) = -5
+    if ( fabs( ppc_determinant( 3, small, 3 ) + 5.0 ) > 1e-12 ){
+        return 1;
+    }
+
+    /*
+     * Test 2: log-det of a matrix whose determinant overflows
+     * */
+    long int n = 200;
+    double *a = (double*)malloc( sizeof(double) * n * n );
+    int sign;
+
+    for (long int i = 0; i < n; i++)
+        for (long int j = 0; j < n; j++)
+            M(i, j, n, a) = (i == j) ? 1e4 : (i > j) ? rand() % 10 : 0.0;
+
+    // Lower triangular: det = 1e4^200, log-det = 200 log(1e4)
+    double logarithm = ppc_log_determinant( n, a, n, &sign );
+
+    if ( sign != 1 || fabs( logarithm - n * log(1e4) ) > 1e-9 || !isinf( ppc_determinant( n, a, n ) ) ){
+        return 2;
+    }
+
+    /*
+     * Test 3: A * A^-1 = I, and the second use of A hits the cache
+     * */
+    long int hits, misses, hits_before, misses_before;
+    double *inverse = (double*)malloc( sizeof(double) * n * n );
+
+    for (long int i = 0; i < n * n; i++)
+        a[i] = 2.0 * rand() / RAND_MAX - 1.0;
+
+    ppc_lu_cache_stats( &hits_before, &misses_before );
+
+    if ( ppc_inverse( n, a, n, inverse, n ) != 0 ){
+        return 3;
+    }
+
+    double condition = ppc_condition_estimate( n, a, n );
+
+    ppc_lu_cache_stats( &hits, &misses );
+
+    if ( misses != misses_before + 1 || hits != hits_before + 1 ){
+        return 4;
+    }
+
+    for (long int i = 0; i < n; i++){
+        for (long int j = 0; j < n; j++){
+            double sum = 0.0;
+            for (long int k = 0; k < n; k++)
+                sum += M(i, k, n, a) * M(k, j, n, inverse);
+            if ( fabs( sum - ((i == j) ? 1.0 : 0.0) ) > 1e-9 )
+                return 5;
+        }
+    }
+
+    /*
+     * Test 4: the estimate is a lower bound of ||A||_1 ||A^-1||_1, and close
+     * */
+    double norm_a = 0.0, norm_inverse = 0.0;
+
+    for (long int j = 0; j < n; j++){
+        double sum_a = 0.0, sum_inverse = 0.0;
+        for (long int i = 0; i < n; i++){
+            sum_a += fabs( M(i, j, n, a) );
+            sum_inverse += fabs( M(i, j, n, inverse) );
+        }
+        norm_a = fmax( norm_a, sum_a );
+        norm_inverse = fmax( norm_inverse, sum_inverse );
+    }
+
+    if ( condition > norm_a * norm_inverse * (1 + 1e-9) || condition < norm_a * norm_inverse / 10 ){
+        return 6;
+    }
+
+    /*
+     * Test 5: a changed matrix is not confused with the cached one, and a
+     * singular matrix has determinant 0
+     * */
+    M(0, 0, n, a) += 1.0;
+    ppc_lu_cache_stats( &hits_before, &misses_before );
+    ppc_determinant( n, a, n );
+    ppc_lu_cache_stats( &hits, &misses );
+
+    if ( misses != misses_before + 1 ){
+        return 7;
+    }
+
+    for (long int j = 0; j < n; j++)
+        M(n - 1, j, n, a) = M(0, j, n, a);
+
+    if ( ppc_determinant( n, a, n ) != 0.0 || !isinf( ppc_condition_estimate( n, a, n ) ) ){
+        return 8;
+    }
+
+    ppc_lu_cache_clear();
+
+    free( a );
+    free( inverse );
+
+    return 0;
+}
@@ -0,0 +1,30 @@
+#ifndef RELATORIO_NUMA_H
+#define RELATORIO_NUMA_H
+
+#include <stdio.h>
+#include <libppc.h>
+
+// Mostra em que nó NUMA estão as páginas de uma matriz, com as contagens de
+// numa_page_distribution() da LibPPC
+static void imprimir_distribuicao_numa(const char *nome, const double *matriz, long int elementos)
+{
+    long int paginas[64];
+    int nos = numa_page_distribution(matriz, sizeof(double) * elementos, paginas, 64);
+
+    if (nos < 0)
+    {
+        printf("  %s: distribuição indisponível neste sistema\n", nome);
+        return;
+    }
+
+    long int total = 0;
+    for (int no = 0; no < nos; no++)
+        total += paginas[no];
+
+    printf("  %s:", nome);
+    for (int no = 0; no < nos; no++)
+        printf(" nó %d = %ld páginas (%.1f%%)", no, paginas[no], total > 0 ? 100.0 * paginas[no] / total : 0.0);
+    printf("\n");
+}
+
+#endif
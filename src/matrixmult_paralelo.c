@@ -1,17 +1,810 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <time.h>
+#include <math.h>
 #include <omp.h>
 #include <libppc.h>
 
+#include "relatorio_numa.h"
+
+// Ordem a partir da qual a recursão de Strassen passa para o GEMM blocado
+#define STRASSEN_CORTE 512
+
+// Fração de não-zeros das matrizes esparsas geradas nos modos esparso e spmv
+#define DENSIDADE_ESPARSA 0.01
+
+// Memória (MB) usada pelo modo ooc quando o usuário não informa
+#define MEMORIA_OOC_MB 1024
+
+// laco = 0: ordem i-j-k original; laco = 1: ordem i-k-j, que percorre m2 e mR
+// por linha. As duas somam os produtos de cada elemento na mesma ordem de k,
+// então o resultado é idêntico; o autotune escolhe a mais rápida
+void multiplicacao_classica(const double *m1, const double *m2, double *mR, int ordem, int laco)
+{
+    if (laco == 1)
+    {
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < ordem; i++)
+        {
+            for (int j = 0; j < ordem; j++)
+            {
+                M(i, j, ordem, mR) = 0.0;
+            }
+
+            for (int k = 0; k < ordem; k++)
+            {
+                double m1_ik = M(i, k, ordem, m1);
+
+                for (int j = 0; j < ordem; j++)
+                {
+                    M(i, j, ordem, mR) += m1_ik * M(k, j, ordem, m2);
+                }
+            }
+        }
+        return;
+    }
+
+    // Paralelizamos os dois loops externos (i e j)
+    // A diretiva collapse(2) funde os dois loops para melhor balanceamento de carga
+    #pragma omp parallel for collapse(2)
+    for (int i = 0; i < ordem; i++)
+    {
+        for (int j = 0; j < ordem; j++)
+        {
+            // Inicializa o elemento da matriz resultado
+            M(i, j, ordem, mR) = 0.0;
+
+            // Calcula o produto escalar da linha i de m1 pela coluna j de m2
+            // Este loop interno (k) não é paralelizado para evitar condições de corrida
+            for (int k = 0; k < ordem; k++)
+            {
+                M(i, j, ordem, mR) += M(i, k, ordem, m1) * M(k, j, ordem, m2);
+            }
+        }
+    }
+}
+
+// mR = m1 * m2 pelo GEMM blocado da LibPPC (ppc_dgemm)
+void multiplicacao_blocada(const double *m1, const double *m2, double *mR, int ordem)
+{
+    ppc_dgemm(ordem, ordem, ordem, 1.0, m1, ordem, m2, ordem, 0.0, mR, ordem);
+}
+
+// c = a + sinal * b, para blocos n x n com leading dimensions próprias.
+// Nos níveis que criam tasks as linhas também são divididas em tasks
+void somar_blocos(long int n, const double *a, long int lda, const double *b, long int ldb,
+                  double sinal, double *c, long int ldc, int paralelo)
+{
+    #pragma omp taskloop if (paralelo) grainsize(64)
+    for (long int i = 0; i < n; i++)
+    {
+        for (long int j = 0; j < n; j++)
+        {
+            M(i, j, ldc, c) = M(i, j, lda, a) + sinal * M(i, j, ldb, b);
+        }
+    }
+}
+
+// Variante de Winograd do algoritmo de Strassen: 7 produtos e 15 somas de
+// submatrizes por nível. Enquanto profundidade > 0 os 7 produtos são criados
+// como tasks; abaixo do corte (ou com ordem ímpar) usa o GEMM blocado.
+// Os produtos P2..P5 são escritos diretamente nos quadrantes de C, então
+// cada nível aloca só 8 blocos para S/T e 3 para P1, P6 e P7
+void strassen_winograd(long int n, const double *a, long int lda, const double *b, long int ldb,
+                       double *c, long int ldc, int corte, int profundidade)
+{
+    if (n <= corte || n % 2 != 0)
+    {
+        ppc_dgemm(n, n, n, 1.0, a, lda, b, ldb, 0.0, c, ldc);
+        return;
+    }
+
+    long int h = n / 2;
+    size_t bloco = sizeof(double) * h * h;
+
+    const double *a11 = a, *a12 = a + h, *a21 = a + h * lda, *a22 = a + h * lda + h;
+    const double *b11 = b, *b12 = b + h, *b21 = b + h * ldb, *b22 = b + h * ldb + h;
+    double *c11 = c, *c12 = c + h, *c21 = c + h * ldc, *c22 = c + h * ldc + h;
+
+    double *s1 = (double *)malloc(bloco), *s2 = (double *)malloc(bloco);
+    double *s3 = (double *)malloc(bloco), *s4 = (double *)malloc(bloco);
+    double *t1 = (double *)malloc(bloco), *t2 = (double *)malloc(bloco);
+    double *t3 = (double *)malloc(bloco), *t4 = (double *)malloc(bloco);
+    double *p1 = (double *)malloc(bloco), *p6 = (double *)malloc(bloco);
+    double *p7 = (double *)malloc(bloco);
+
+    somar_blocos(h, a21, lda, a22, lda, 1.0, s1, h, profundidade > 0);
+    somar_blocos(h, s1, h, a11, lda, -1.0, s2, h, profundidade > 0);
+    somar_blocos(h, a11, lda, a21, lda, -1.0, s3, h, profundidade > 0);
+    somar_blocos(h, a12, lda, s2, h, -1.0, s4, h, profundidade > 0);
+    somar_blocos(h, b12, ldb, b11, ldb, -1.0, t1, h, profundidade > 0);
+    somar_blocos(h, b22, ldb, t1, h, -1.0, t2, h, profundidade > 0);
+    somar_blocos(h, b22, ldb, b12, ldb, -1.0, t3, h, profundidade > 0);
+    somar_blocos(h, t2, h, b21, ldb, -1.0, t4, h, profundidade > 0);
+
+    if (profundidade > 0)
+    {
+        #pragma omp task
+        strassen_winograd(h, a11, lda, b11, ldb, p1, h, corte, profundidade - 1);
+        #pragma omp task
+        strassen_winograd(h, a12, lda, b21, ldb, c11, ldc, corte, profundidade - 1);
+        #pragma omp task
+        strassen_winograd(h, s4, h, b22, ldb, c12, ldc, corte, profundidade - 1);
+        #pragma omp task
+        strassen_winograd(h, a22, lda, t4, h, c21, ldc, corte, profundidade - 1);
+        #pragma omp task
+        strassen_winograd(h, s1, h, t1, h, c22, ldc, corte, profundidade - 1);
+        #pragma omp task
+        strassen_winograd(h, s2, h, t2, h, p6, h, corte, profundidade - 1);
+        #pragma omp task
+        strassen_winograd(h, s3, h, t3, h, p7, h, corte, profundidade - 1);
+        #pragma omp taskwait
+    }
+    else
+    {
+        strassen_winograd(h, a11, lda, b11, ldb, p1, h, corte, 0);
+        strassen_winograd(h, a12, lda, b21, ldb, c11, ldc, corte, 0);
+        strassen_winograd(h, s4, h, b22, ldb, c12, ldc, corte, 0);
+        strassen_winograd(h, a22, lda, t4, h, c21, ldc, corte, 0);
+        strassen_winograd(h, s1, h, t1, h, c22, ldc, corte, 0);
+        strassen_winograd(h, s2, h, t2, h, p6, h, corte, 0);
+        strassen_winograd(h, s3, h, t3, h, p7, h, corte, 0);
+    }
+
+    // U1 = P1 + P2, U2 = P1 + P6, U3 = U2 + P7, U4 = U2 + P5,
+    // U5 = U4 + P3, U6 = U3 - P4, U7 = U3 + P5
+    #pragma omp taskloop if (profundidade > 0) grainsize(64)
+    for (long int i = 0; i < h; i++)
+    {
+        for (long int j = 0; j < h; j++)
+        {
+            double u2 = M(i, j, h, p1) + M(i, j, h, p6);
+            double u3 = u2 + M(i, j, h, p7);
+            double p5 = M(i, j, ldc, c22);
+
+            M(i, j, ldc, c11) += M(i, j, h, p1);
+            M(i, j, ldc, c12) += u2 + p5;
+            M(i, j, ldc, c21) = u3 - M(i, j, ldc, c21);
+            M(i, j, ldc, c22) = u3 + p5;
+        }
+    }
+
+    free(s1);
+    free(s2);
+    free(s3);
+    free(s4);
+    free(t1);
+    free(t2);
+    free(t3);
+    free(t4);
+    free(p1);
+    free(p6);
+    free(p7);
+}
+
+// Ordens que não são da forma c * 2^d com c <= corte são completadas com zeros
+// até a menor ordem desse tipo, para que todos os níveis da recursão sejam pares
+void multiplicacao_strassen(const double *m1, const double *m2, double *mR, int ordem, int corte)
+{
+    long int n = ordem;
+    long int n_pad = n;
+    int niveis = 0;
+
+    while (n_pad > corte)
+    {
+        n_pad = (n_pad + 1) / 2;
+        niveis++;
+    }
+    n_pad <<= niveis;
+
+    // Profundidade de tasks: a menor que gera ao menos 4 produtos por thread
+    int profundidade = 0;
+    long int tasks = 1;
+    while (profundidade < niveis && tasks < 4L * omp_get_max_threads())
+    {
+        tasks *= 7;
+        profundidade++;
+    }
+
+    const double *a = m1, *b = m2;
+    double *c = mR;
+    double *a_pad = NULL, *b_pad = NULL, *c_pad = NULL;
+
+    if (n_pad != n)
+    {
+        a_pad = (double *)calloc(n_pad * n_pad, sizeof(double));
+        b_pad = (double *)calloc(n_pad * n_pad, sizeof(double));
+        c_pad = (double *)malloc(sizeof(double) * n_pad * n_pad);
+
+        for (long int i = 0; i < n; i++)
+        {
+            memcpy(&M(i, 0, n_pad, a_pad), &M(i, 0, n, m1), sizeof(double) * n);
+            memcpy(&M(i, 0, n_pad, b_pad), &M(i, 0, n, m2), sizeof(double) * n);
+        }
+
+        a = a_pad;
+        b = b_pad;
+        c = c_pad;
+    }
+
+    // Sem nenhum nível de Strassen o produto é um único GEMM, que fora de uma
+    // região paralela usa todas as threads
+    if (niveis == 0)
+        ppc_dgemm(n, n, n, 1.0, a, n, b, n, 0.0, c, n);
+    else
+    {
+        #pragma omp parallel
+        {
+            #pragma omp single
+            strassen_winograd(n_pad, a, n_pad, b, n_pad, c, n_pad, corte, profundidade);
+        }
+    }
+
+    if (n_pad != n)
+    {
+        for (long int i = 0; i < n; i++)
+        {
+            memcpy(&M(i, 0, n, mR), &M(i, 0, n_pad, c_pad), sizeof(double) * n);
+        }
+
+        free(a_pad);
+        free(b_pad);
+        free(c_pad);
+    }
+}
+
+// Multiplicação medida pelo autotune: o modo (blocado ou classico) e a
+// ordem dos laços do modo clássico
+typedef struct
+{
+    const char *modo;
+    const double *m1;
+    const double *m2;
+    double *mR;
+    int ordem;
+    int laco;
+} medicao_multiplicacao;
+
+void executar_medicao(void *contexto)
+{
+    medicao_multiplicacao *medicao = (medicao_multiplicacao *)contexto;
+
+    if (strcmp(medicao->modo, "blocado") == 0)
+        multiplicacao_blocada(medicao->m1, medicao->m2, medicao->mR, medicao->ordem);
+    else
+        multiplicacao_classica(medicao->m1, medicao->m2, medicao->mR, medicao->ordem, medicao->laco);
+}
+
+// Menor tempo de algumas execuções de uma multiplicação no modo dado
+double medir_multiplicacao(const char *modo, const double *m1, const double *m2, double *mR,
+                           int ordem, int laco)
+{
+    medicao_multiplicacao medicao = {modo, m1, m2, mR, ordem, laco};
+
+    return ppc_profile_time(NULL, executar_medicao, &medicao);
+}
+
+// Número de threads mais rápido para um modo, com as threads fixadas em CPUs
+// como nas multiplicações do programa
+int autoajustar_threads(const char *modo, const double *m1, const double *m2, double *mR,
+                        int ordem, int laco)
+{
+    medicao_multiplicacao medicao = {modo, m1, m2, mR, ordem, laco};
+
+    printf("\nAutoajuste do número de threads (%s):\n", modo);
+    return ppc_profile_tune_threads(NULL, executar_medicao, &medicao, 1);
+}
+
+// Modo autotune: escolhe, para esta ordem e esta máquina, a blocagem do GEMM
+// (uma dimensão por vez, mantendo as outras), a ordem dos laços do modo
+// clássico e o número de threads de cada modo, e grava no perfil
+void autoajustar(const double *m1, const double *m2, double *mR, int ordem)
+{
+    const long int opcoes_kc[] = {128, 192, 256, 384, 512};
+    const long int opcoes_mc[] = {48, 72, 96, 144, 192, 288};
+    const long int opcoes_nc[] = {512, 1024, 2048, 4096, 8192};
+    int max_threads = omp_get_max_threads();
+    long int mc, kc, nc;
+    double tempo, melhor_tempo;
+
+    ppc_gemm_get_blocking(&mc, &kc, &nc);
+
+    printf("Autoajuste da blocagem do GEMM (%d threads):\n", max_threads);
+
+    melhor_tempo = -1.0;
+    for (unsigned i = 0; i < sizeof(opcoes_kc) / sizeof(opcoes_kc[0]); i++)
+    {
+        ppc_gemm_set_blocking(mc, opcoes_kc[i], nc);
+        tempo = medir_multiplicacao("blocado", m1, m2, mR, ordem, 0);
+        printf("  KC=%ld: %.6f s\n", opcoes_kc[i], tempo);
+        if (melhor_tempo < 0.0 || tempo < melhor_tempo)
+        {
+            melhor_tempo = tempo;
+            kc = opcoes_kc[i];
+        }
+    }
+
+    melhor_tempo = -1.0;
+    for (unsigned i = 0; i < sizeof(opcoes_mc) / sizeof(opcoes_mc[0]); i++)
+    {
+        ppc_gemm_set_blocking(opcoes_mc[i], kc, nc);
+        tempo = medir_multiplicacao("blocado", m1, m2, mR, ordem, 0);
+        printf("  MC=%ld: %.6f s\n", opcoes_mc[i], tempo);
+        if (melhor_tempo < 0.0 || tempo < melhor_tempo)
+        {
+            melhor_tempo = tempo;
+            mc = opcoes_mc[i];
+        }
+    }
+
+    melhor_tempo = -1.0;
+    for (unsigned i = 0; i < sizeof(opcoes_nc) / sizeof(opcoes_nc[0]); i++)
+    {
+        ppc_gemm_set_blocking(mc, kc, opcoes_nc[i]);
+        tempo = medir_multiplicacao("blocado", m1, m2, mR, ordem, 0);
+        printf("  NC=%ld: %.6f s\n", opcoes_nc[i], tempo);
+        if (melhor_tempo < 0.0 || tempo < melhor_tempo)
+        {
+            melhor_tempo = tempo;
+            nc = opcoes_nc[i];
+        }
+    }
+
+    ppc_gemm_set_blocking(mc, kc, nc);
+    ppc_gemm_get_blocking(&mc, &kc, &nc);
+
+    int threads_blocado = autoajustar_threads("blocado", m1, m2, mR, ordem, 0);
+
+    printf("\nAutoajuste da ordem dos laços do modo clássico:\n");
+    double tempo_ijk = medir_multiplicacao("classico", m1, m2, mR, ordem, 0);
+    double tempo_ikj = medir_multiplicacao("classico", m1, m2, mR, ordem, 1);
+    int laco = (tempo_ikj < tempo_ijk) ? 1 : 0;
+    printf("  i-j-k: %.6f s\n  i-k-j: %.6f s\n", tempo_ijk, tempo_ikj);
+
+    int threads_classico = autoajustar_threads("classico", m1, m2, mR, ordem, laco);
+
+    ppc_profile_set("gemm_mc", ordem, mc);
+    ppc_profile_set("gemm_kc", ordem, kc);
+    ppc_profile_set("gemm_nc", ordem, nc);
+    ppc_profile_set("matrixmult_laco", ordem, laco);
+    ppc_profile_set("matrixmult_threads_blocado", ordem, threads_blocado);
+    ppc_profile_set("matrixmult_threads_classico", ordem, threads_classico);
+
+    printf("\nMelhores parâmetros para ordem %d:\n", ordem);
+    printf("  MC=%ld KC=%ld NC=%ld\n", mc, kc, nc);
+    printf("  Laços do modo clássico: %s\n", laco ? "i-k-j" : "i-j-k");
+    printf("  Threads: blocado=%d classico=%d\n", threads_blocado, threads_classico);
+    printf("Perfil salvo em: %s\n", ppc_profile_filename());
+}
+
+int termina_com(const char *texto, const char *sufixo)
+{
+    size_t n = strlen(texto), m = strlen(sufixo);
+
+    return n >= m && strcmp(texto + n - m, sufixo) == 0;
+}
+
+// Matriz esparsa de um arquivo .csr (formato CSR da LibPPC) ou de um arquivo
+// denso convertido para CSR. Se o arquivo não existe, gera uma matriz
+// aleatória com a densidade pedida e salva no formato indicado pela extensão
+ppc_csr_t *carregar_esparsa(const char *arquivo, int ordem, double densidade, const char *nome)
+{
+    ppc_csr_t *matriz;
+
+    if (access(arquivo, F_OK) == 0)
+    {
+        printf("Carregando %s do arquivo...\n", nome);
+
+        if (termina_com(arquivo, ".csr"))
+        {
+            matriz = load_csr_matrix(arquivo);
+            if (matriz != NULL && (matriz->lines != ordem || matriz->columns != ordem))
+            {
+                fprintf(stderr, "Erro: %s tem ordem %ldx%ld, não %dx%d.\n", arquivo,
+                        matriz->lines, matriz->columns, ordem, ordem);
+                free_csr_matrix(matriz);
+                return NULL;
+            }
+        }
+        else
+        {
+            double *densa = load_double_matrix(arquivo, ordem, ordem);
+            if (densa == NULL)
+                return NULL;
+
+            matriz = dense_to_csr_matrix(densa, ordem, ordem);
+            free(densa);
+        }
+    }
+    else
+    {
+        printf("Gerando nova matriz esparsa aleatória para %s...\n", nome);
+        matriz = generate_random_csr_matrix(ordem, ordem, densidade, rand());
+        if (matriz == NULL)
+            return NULL;
+
+        if (termina_com(arquivo, ".csr"))
+        {
+            save_csr_matrix(matriz, arquivo);
+        }
+        else
+        {
+            double *densa = csr_to_dense_matrix(matriz);
+            save_double_matrix(densa, ordem, ordem, arquivo);
+            free(densa);
+        }
+    }
+
+    if (matriz != NULL)
+        printf("  %s: %ld não-zeros (%.4f%%)\n", nome, matriz->nnz, 100.0 * matriz->nnz / ((double)ordem * ordem));
+
+    return matriz;
+}
+
+// Modos esparso (SpGEMM, m1 e m2 esparsas) e spmv (m1 esparsa, m2 um vetor
+// denso de ordem elementos). Nada é alocado com ordem x ordem elementos,
+// exceto a saída densa quando pedida
+int executar_esparso(int ordem, const char *arquivo_m1, const char *arquivo_m2, const char *modo,
+                     double densidade, int saida_densa)
+{
+    ppc_csr_t *m1 = carregar_esparsa(arquivo_m1, ordem, densidade, "Matriz 1");
+    if (m1 == NULL)
+    {
+        fprintf(stderr, "Erro: Não foi possível carregar as matrizes.\n");
+        return 1;
+    }
+
+    if (strcmp(modo, "spmv") == 0)
+    {
+        double *x;
+        if (access(arquivo_m2, F_OK) == 0)
+        {
+            printf("Carregando Vetor do arquivo...\n");
+            x = load_double_vector(arquivo_m2, ordem);
+        }
+        else
+        {
+            printf("Gerando novos valores aleatórios para o Vetor...\n");
+            x = generate_random_double_vector(ordem, 0.0, 10.0);
+            save_double_vector(x, ordem, arquivo_m2);
+        }
+
+        if (x == NULL)
+        {
+            fprintf(stderr, "Erro: Não foi possível carregar o vetor.\n");
+            free_csr_matrix(m1);
+            return 1;
+        }
+
+        double *y = (double *)malloc(sizeof(double) * ordem);
+
+        double inicio = omp_get_wtime();
+        ppc_csr_spmv(m1, x, y);
+        double tempo_execucao = omp_get_wtime() - inicio;
+
+        printf("\nVetor Resultado (primeiros %d elementos):\n", ordem < 10 ? ordem : 10);
+        print_double_vector(y, ordem < 10 ? ordem : 10, 10);
+        printf("\n");
+        printf("Tempo de execução (multiplicação): %.6f segundos\n", tempo_execucao);
+        printf("Desempenho: %.3f GFLOP/s\n", 2.0 * m1->nnz / tempo_execucao * 1e-9);
+
+        save_double_vector(y, ordem, "matrixmult_paralelo.out");
+        printf("Vetor resultado salvo em: matrixmult_paralelo.out\n");
+
+        free(x);
+        free(y);
+        free_csr_matrix(m1);
+
+        return 0;
+    }
+
+    ppc_csr_t *m2 = carregar_esparsa(arquivo_m2, ordem, densidade, "Matriz 2");
+    if (m2 == NULL)
+    {
+        fprintf(stderr, "Erro: Não foi possível carregar as matrizes.\n");
+        free_csr_matrix(m1);
+        return 1;
+    }
+
+    // Multiplicações-somas do produto, para o desempenho em GFLOP/s
+    long int produtos = 0;
+    for (long int p = 0; p < m1->nnz; p++)
+        produtos += m2->row_ptr[m1->col_idx[p] + 1] - m2->row_ptr[m1->col_idx[p]];
+
+    double inicio = omp_get_wtime();
+    ppc_csr_t *mR = ppc_csr_spgemm(m1, m2);
+    double tempo_execucao = omp_get_wtime() - inicio;
+
+    if (mR == NULL)
+    {
+        fprintf(stderr, "Erro: Memória insuficiente para o resultado.\n");
+        free_csr_matrix(m1);
+        free_csr_matrix(m2);
+        return 1;
+    }
+
+    printf("\nMatriz Resultado: %ld não-zeros (%.4f%%)\n", mR->nnz, 100.0 * mR->nnz / ((double)ordem * ordem));
+    printf("Tempo de execução (multiplicação): %.6f segundos\n", tempo_execucao);
+    printf("Desempenho: %.3f GFLOP/s\n", 2.0 * produtos / tempo_execucao * 1e-9);
+
+    if (saida_densa)
+    {
+        double *densa = csr_to_dense_matrix(mR);
+        if (densa == NULL)
+        {
+            fprintf(stderr, "Erro: Memória insuficiente para a saída densa.\n");
+        }
+        else
+        {
+            save_double_matrix(densa, ordem, ordem, "matrixmult_paralelo.out");
+            printf("Matriz resultado (densa) salva em: matrixmult_paralelo.out\n");
+            free(densa);
+        }
+    }
+    else
+    {
+        save_csr_matrix(mR, "matrixmult_paralelo.csr");
+        printf("Matriz resultado (CSR) salva em: matrixmult_paralelo.csr\n");
+    }
+
+    free_csr_matrix(m1);
+    free_csr_matrix(m2);
+    free_csr_matrix(mR);
+
+    return 0;
+}
+
+// Cópia em float de uma matriz, tocada pelas threads em faixas de bloco
+// elementos com a mesma partição estática do GEMM
+float *converter_para_float(const double *matriz, long int elementos, long int bloco)
+{
+    float *copia = (float *)malloc(sizeof(float) * elementos);
+    long int blocos = (elementos + bloco - 1) / bloco;
+
+    #pragma omp parallel for schedule(static)
+    for (long int b = 0; b < blocos; b++)
+    {
+        long int fim = (b + 1) * bloco < elementos ? (b + 1) * bloco : elementos;
+
+        for (long int i = b * bloco; i < fim; i++)
+            copia[i] = (float)matriz[i];
+    }
+
+    return copia;
+}
+
+// Passo s do modo ooc: ladrilho (i, j) de mR e índice p da soma
+void passo_ladrilhos(long int s, long int n_ladrilhos, long int *i, long int *j, long int *p)
+{
+    *i = s / (n_ladrilhos * n_ladrilhos);
+    *j = (s / n_ladrilhos) % n_ladrilhos;
+    *p = s % n_ladrilhos;
+}
+
+// Linhas (ou colunas) do ladrilho t; o último pode ser menor
+long int tamanho_ladrilho(long int ordem, long int ladrilho, long int t)
+{
+    return (ordem - t * ladrilho < ladrilho) ? ordem - t * ladrilho : ladrilho;
+}
+
+// Modo ooc (fora da memória): m1, m2 e o resultado ficam nos arquivos e só
+// passam pela memória em ladrilhos. O ladrilho de mR (i, j) acumula os
+// produtos m1(i, p) * m2(p, j) de todos os p; enquanto um par de ladrilhos
+// é multiplicado, uma task lê o próximo par e outra grava o ladrilho de mR
+// terminado antes. São 2 buffers para cada matriz, 6 ladrilhos ao todo, e o
+// tamanho do ladrilho sai do limite de memoria_mb
+int multiplicacao_fora_da_memoria(int ordem, const char *arquivo_m1, const char *arquivo_m2,
+                                  const char *arquivo_saida, long int memoria_mb)
+{
+    long int mc, kc, nc;
+    ppc_gemm_get_blocking(&mc, &kc, &nc);
+
+    // Buffers de empacotamento do GEMM de cada thread também contam
+    int threads = omp_get_max_threads();
+    double reserva = (double)threads * ((mc + 8) * kc + kc * (nc + 16)) * sizeof(double);
+    double disponivel = memoria_mb * 1048576.0 - reserva;
+    long int ladrilho = (disponivel > 0.0) ? (long int)sqrt(disponivel / (6.0 * sizeof(double))) : 0;
+
+    if (ladrilho > ordem)
+        ladrilho = ordem;
+
+    if (ladrilho < 64 && ladrilho < ordem)
+    {
+        fprintf(stderr, "Erro: Memória insuficiente; o modo ooc precisa de pelo menos %.0f MB com %d threads.\n",
+                ceil((reserva + 6.0 * 64 * 64 * sizeof(double)) / 1048576.0), threads);
+        return 1;
+    }
+
+    // As entradas são abertas e conferidas antes, para que um erro nelas não
+    // trunque o arquivo de saída
+    FILE *fa = fopen(arquivo_m1, "rb");
+    if (fa == NULL)
+    {
+        perror("Erro: Não foi possível abrir o arquivo da matriz 1");
+        return 1;
+    }
+
+    FILE *fb = fopen(arquivo_m2, "rb");
+    if (fb == NULL)
+    {
+        perror("Erro: Não foi possível abrir o arquivo da matriz 2");
+        fclose(fa);
+        return 1;
+    }
+
+    off_t bytes = (off_t)sizeof(double) * ordem * ordem;
+    fseeko(fa, 0, SEEK_END);
+    fseeko(fb, 0, SEEK_END);
+    if (ftello(fa) < bytes || ftello(fb) < bytes)
+    {
+        fprintf(stderr, "Erro: Os arquivos não têm o tamanho de uma matriz %dx%d.\n", ordem, ordem);
+        fclose(fa);
+        fclose(fb);
+        return 1;
+    }
+
+    FILE *fc = fopen(arquivo_saida, "wb");
+    if (fc == NULL || ftruncate(fileno(fc), bytes) != 0)
+    {
+        perror("Erro: Não foi possível criar o arquivo da matriz resultado");
+        if (fc != NULL)
+            fclose(fc);
+        fclose(fa);
+        fclose(fb);
+        return 1;
+    }
+
+    long int n_ladrilhos = (ordem + ladrilho - 1) / ladrilho;
+    long int passos = n_ladrilhos * n_ladrilhos * n_ladrilhos;
+    long int elementos = ladrilho * ladrilho;
+    double *ta[2], *tb[2], *tc[2];
+
+    for (int t = 0; t < 2; t++)
+    {
+        ta[t] = (double *)malloc(sizeof(double) * elementos);
+        tb[t] = (double *)malloc(sizeof(double) * elementos);
+        tc[t] = (double *)malloc(sizeof(double) * elementos);
+    }
+
+    // Linhas de cada task de cálculo: várias tasks por thread, cada uma com
+    // linhas suficientes para amortizar o empacotamento de m2
+    long int bloco = ppc_gemm_row_block();
+    long int faixa = (ladrilho + 4 * threads - 1) / (4 * threads);
+    faixa = ((faixa + bloco - 1) / bloco) * bloco;
+
+    printf("Ladrilho: %ldx%ld (%ld passos, %.1f MB de ladrilhos)\n", ladrilho, ladrilho, passos,
+           6.0 * elementos * sizeof(double) / 1048576.0);
+
+    double lidos = 0.0;
+    int erro_es = 0;
+
+    #pragma omp parallel
+    {
+        #pragma omp single
+        {
+            long int t0 = tamanho_ladrilho(ordem, ladrilho, 0);
+
+            // O primeiro par é lido antes de começar
+            erro_es |= read_double_matrix_tile(fa, ordem, 0, 0, t0, t0, ta[0], t0);
+            erro_es |= read_double_matrix_tile(fb, ordem, 0, 0, t0, t0, tb[0], t0);
+            lidos += 2.0 * t0 * t0;
+
+            for (long int s = 0; s < passos && !erro_es; s++)
+            {
+                long int i, j, p;
+                passo_ladrilhos(s, n_ladrilhos, &i, &j, &p);
+
+                long int tm = tamanho_ladrilho(ordem, ladrilho, i);
+                long int tn = tamanho_ladrilho(ordem, ladrilho, j);
+                long int tk = tamanho_ladrilho(ordem, ladrilho, p);
+                double *a = ta[s % 2], *b = tb[s % 2], *c = tc[(s / n_ladrilhos) % 2];
+
+                // Leitura do próximo par, no outro buffer
+                if (s + 1 < passos)
+                {
+                    long int i2, j2, p2;
+                    passo_ladrilhos(s + 1, n_ladrilhos, &i2, &j2, &p2);
+
+                    long int tm2 = tamanho_ladrilho(ordem, ladrilho, i2);
+                    long int tn2 = tamanho_ladrilho(ordem, ladrilho, j2);
+                    long int tk2 = tamanho_ladrilho(ordem, ladrilho, p2);
+                    double *a2 = ta[(s + 1) % 2], *b2 = tb[(s + 1) % 2];
+
+                    lidos += (double)tm2 * tk2 + (double)tk2 * tn2;
+
+                    #pragma omp task
+                    {
+                        int erro = read_double_matrix_tile(fa, ordem, i2 * ladrilho, p2 * ladrilho, tm2, tk2, a2, tk2);
+                        erro |= read_double_matrix_tile(fb, ordem, p2 * ladrilho, j2 * ladrilho, tk2, tn2, b2, tn2);
+                        if (erro)
+                        {
+                            #pragma omp atomic write
+                            erro_es = 1;
+                        }
+                    }
+                }
+
+                // Gravação do ladrilho de mR terminado no passo anterior
+                if (p == 0 && s > 0)
+                {
+                    long int i0, j0, p0;
+                    passo_ladrilhos(s - 1, n_ladrilhos, &i0, &j0, &p0);
+
+                    long int tm0 = tamanho_ladrilho(ordem, ladrilho, i0);
+                    long int tn0 = tamanho_ladrilho(ordem, ladrilho, j0);
+                    double *c0 = tc[((s - 1) / n_ladrilhos) % 2];
+
+                    #pragma omp task
+                    {
+                        if (write_double_matrix_tile(fc, ordem, i0 * ladrilho, j0 * ladrilho, tm0, tn0, c0, tn0) != 0)
+                        {
+                            #pragma omp atomic write
+                            erro_es = 1;
+                        }
+                    }
+                }
+
+                for (long int r = 0; r < tm; r += faixa)
+                {
+                    long int linhas = (tm - r < faixa) ? tm - r : faixa;
+
+                    #pragma omp task
+                    ppc_dgemm(linhas, tn, tk, 1.0, &M(r, 0, tk, a), tk, b, tn,
+                              (p == 0) ? 0.0 : 1.0, &M(r, 0, tn, c), tn);
+                }
+
+                #pragma omp taskwait
+            }
+
+            if (!erro_es)
+            {
+                long int i0, j0, p0;
+                passo_ladrilhos(passos - 1, n_ladrilhos, &i0, &j0, &p0);
+
+                long int tm0 = tamanho_ladrilho(ordem, ladrilho, i0);
+                long int tn0 = tamanho_ladrilho(ordem, ladrilho, j0);
+
+                erro_es |= write_double_matrix_tile(fc, ordem, i0 * ladrilho, j0 * ladrilho, tm0, tn0,
+                                                    tc[((passos - 1) / n_ladrilhos) % 2], tn0);
+            }
+        }
+    }
+
+    printf("Dados lidos do disco: %.2f GB\n", lidos * sizeof(double) / 1e9);
+
+    for (int t = 0; t < 2; t++)
+    {
+        free(ta[t]);
+        free(tb[t]);
+        free(tc[t]);
+    }
+
+    fclose(fa);
+    fclose(fb);
+    if (fclose(fc) != 0)
+        erro_es = 1;
+
+    if (erro_es)
+    {
+        fprintf(stderr, "Erro: Falha de leitura ou escrita nos arquivos das matrizes.\n");
+        return 1;
+    }
+
+    return 0;
+}
+
 int main(int argc, char **argv)
 {
     // Valida argumentos passados via terminal
-    if (argc != 4)
+    if (argc < 4 || argc > 7)
     {
-        fprintf(stderr, "Uso: %s <ordem> <arquivo_matriz1> <arquivo_matriz2>\n", argv[0]);
-        fprintf(stderr, "Exemplo: %s 3 matriz1.in matriz2.in\n", argv[0]);
+        fprintf(stderr, "Uso: %s <ordem> <arquivo_matriz1> <arquivo_matriz2> [modo] [corte]\n", argv[0]);
+        fprintf(stderr, "     %s <ordem> <arquivo_matriz1> <arquivo_matriz2> esparso|spmv [densidade] [densa|esparsa]\n", argv[0]);
+        fprintf(stderr, "     %s <ordem> <arquivo_matriz1> <arquivo_matriz2> ooc [memoria_MB]\n", argv[0]);
+        fprintf(stderr, "Modos: classico (padrão), blocado, strassen, float, misto, autotune, esparso, spmv, ooc\n");
+        fprintf(stderr, "Exemplo: %s 3 matriz1.in matriz2.in blocado\n", argv[0]);
         return 1;
     }
 
@@ -20,6 +813,13 @@ int main(int argc, char **argv)
     int ordem = atoi(argv[1]);
     const char *arquivo_m1 = argv[2];
     const char *arquivo_m2 = argv[3];
+    const char *modo = (argc > 4) ? argv[4] : "classico";
+    int esparso = strcmp(modo, "esparso") == 0 || strcmp(modo, "spmv") == 0;
+    int fora_da_memoria = strcmp(modo, "ooc") == 0;
+    int corte = (argc > 5 && strcmp(modo, "strassen") == 0) ? atoi(argv[5]) : STRASSEN_CORTE;
+    double densidade = (argc > 5 && esparso) ? atof(argv[5]) : DENSIDADE_ESPARSA;
+    long int memoria_mb = (argc > 5 && fora_da_memoria) ? atol(argv[5]) : MEMORIA_OOC_MB;
+    int saida_densa = (argc > 6) && strcmp(argv[6], "densa") == 0;
 
     if (ordem <= 0)
     {
@@ -27,23 +827,126 @@ int main(int argc, char **argv)
         return 1;
     }
 
+    if (strcmp(modo, "classico") != 0 && strcmp(modo, "blocado") != 0 && strcmp(modo, "strassen") != 0 &&
+        strcmp(modo, "autotune") != 0 && strcmp(modo, "float") != 0 && strcmp(modo, "misto") != 0 &&
+        !esparso && !fora_da_memoria)
+    {
+        fprintf(stderr, "Erro: Modo desconhecido '%s'.\n", modo);
+        return 1;
+    }
+
+    if (fora_da_memoria && memoria_mb <= 0)
+    {
+        fprintf(stderr, "Erro: A memória do modo ooc deve ser um número positivo de MB.\n");
+        return 1;
+    }
+
+    if (esparso && (densidade <= 0.0 || densidade > 1.0))
+    {
+        fprintf(stderr, "Erro: A densidade deve estar entre 0 e 1.\n");
+        return 1;
+    }
+
+    if (argc > 6 && (!esparso || (strcmp(argv[6], "densa") != 0 && strcmp(argv[6], "esparsa") != 0)))
+    {
+        fprintf(stderr, "Erro: Formato de saída desconhecido '%s'.\n", argv[6]);
+        return 1;
+    }
+
+    if (corte < 16)
+    {
+        fprintf(stderr, "Erro: O corte do Strassen deve ser pelo menos 16.\n");
+        return 1;
+    }
+
+    // Blocagem, laços e threads ajustados para esta máquina pelo modo
+    // autotune, se houver perfil; as threads do modo clássico e as do GEMM
+    // blocado são ajustadas separadamente
+    long int mc, kc, nc;
+    ppc_gemm_get_blocking(&mc, &kc, &nc);
+    ppc_gemm_set_blocking(ppc_profile_get("gemm_mc", ordem, mc),
+                          ppc_profile_get("gemm_kc", ordem, kc),
+                          ppc_profile_get("gemm_nc", ordem, nc));
+    ppc_gemm_get_blocking(&mc, &kc, &nc);
+
+    int laco = ppc_profile_get("matrixmult_laco", ordem, 0);
+    if (strcmp(modo, "autotune") != 0 && !esparso)
+        ppc_profile_apply_threads(strcmp(modo, "classico") == 0 ? "matrixmult_threads_classico"
+                                                                : "matrixmult_threads_blocado", ordem);
+
     printf("Multiplicação de Matrizes (Paralelo)\n");
     printf("Ordem das matrizes: %dx%d\n", ordem, ordem);
     printf("Matriz 1: %s\n", arquivo_m1);
     printf("Matriz 2: %s\n", arquivo_m2);
+    printf("Modo: %s\n", modo);
+    if (strcmp(modo, "strassen") == 0)
+        printf("Corte do Strassen: %d\n", corte);
+    if (esparso)
+    {
+        printf("Densidade das matrizes geradas: %g\n", densidade);
+        printf("Número de threads disponíveis: %d\n\n", omp_get_max_threads());
+
+        return executar_esparso(ordem, arquivo_m1, arquivo_m2, modo, densidade, saida_densa);
+    }
+    printf("Micro-kernel GEMM: %s\n", ppc_gemm_kernel_name());
+    printf("Blocagem do GEMM: MC=%ld KC=%ld NC=%ld\n", mc, kc, nc);
+    if (strcmp(modo, "classico") == 0)
+        printf("Ordem dos laços: %s\n", laco ? "i-k-j" : "i-j-k");
     printf("Número de threads disponíveis: %d\n", omp_get_max_threads());
+
+    // Threads fixas em CPUs, espalhadas pelos nós NUMA, para que cada uma
+    // continue perto das páginas que tocou primeiro
+    if (ppc_pin_threads())
+        printf("Afinidade: threads fixadas em CPUs (spread)\n");
+    else
+        printf("Afinidade: definida pelo runtime OpenMP (OMP_PROC_BIND/OMP_PLACES)\n");
     printf("\n");
 
+    if (fora_da_memoria)
+    {
+        // As matrizes não são carregadas: só os arquivos são usados
+        for (int m = 0; m < 2; m++)
+        {
+            const char *arquivo = (m == 0) ? arquivo_m1 : arquivo_m2;
+
+            if (access(arquivo, F_OK) != 0)
+            {
+                printf("Gerando novos valores aleatórios para Matriz %d (direto no arquivo)...\n", m + 1);
+                if (generate_random_double_matrix_file(ordem, ordem, arquivo) != 0)
+                    return 1;
+            }
+        }
+
+        printf("Limite de memória: %ld MB\n", memoria_mb);
+
+        double inicio = omp_get_wtime();
+
+        if (multiplicacao_fora_da_memoria(ordem, arquivo_m1, arquivo_m2, "matrixmult_paralelo.out", memoria_mb) != 0)
+            return 1;
+
+        double tempo_execucao = omp_get_wtime() - inicio;
+
+        printf("Tempo de execução (multiplicação): %.6f segundos\n", tempo_execucao);
+        printf("Desempenho: %.3f GFLOP/s\n", 2.0 * ordem * ordem * (double)ordem / tempo_execucao * 1e-9);
+        printf("Matriz resultado salva em: matrixmult_paralelo.out\n");
+
+        return 0;
+    }
+
+    // As linhas de m1 e mR são tocadas pela primeira vez pela thread que vai
+    // calculá-las, com a mesma partição estática do modo escolhido
+    long int bloco_linhas = (strcmp(modo, "classico") == 0 || strcmp(modo, "strassen") == 0) ? 1 : ppc_gemm_row_block();
+
     double *m1;
     if (access(arquivo_m1, F_OK) == 0)
     {
         printf("Carregando Matriz 1 do arquivo...\n");
-        m1 = load_double_matrix(arquivo_m1, ordem, ordem);
+        m1 = load_double_matrix_first_touch(arquivo_m1, ordem, ordem, bloco_linhas);
     }
     else
     {
         printf("Gerando novos valores aleatórios para Matriz 1...\n");
-        m1 = generate_random_double_matrix(ordem, ordem);
+        m1 = generate_random_double_matrix_first_touch(ordem, ordem, bloco_linhas);
         save_double_matrix(m1, ordem, ordem, arquivo_m1);
     }
 
@@ -51,15 +954,35 @@ int main(int argc, char **argv)
     if (access(arquivo_m2, F_OK) == 0)
     {
         printf("Carregando Matriz 2 do arquivo...\n");
-        m2 = load_double_matrix(arquivo_m2, ordem, ordem);
+        m2 = load_double_matrix_first_touch(arquivo_m2, ordem, ordem, bloco_linhas);
     }
     else
     {
         printf("Gerando novos valores aleatórios para Matriz 2...\n");
-        m2 = generate_random_double_matrix(ordem, ordem);
+        m2 = generate_random_double_matrix_first_touch(ordem, ordem, bloco_linhas);
         save_double_matrix(m2, ordem, ordem, arquivo_m2);
     }
 
+    if (m1 == NULL || m2 == NULL)
+    {
+        fprintf(stderr, "Erro: Não foi possível carregar as matrizes.\n");
+        return 1;
+    }
+
+    if (strcmp(modo, "autotune") == 0)
+    {
+        double *mR = alloc_double_matrix_first_touch(ordem, ordem, bloco_linhas);
+
+        printf("\n");
+        autoajustar(m1, m2, mR, ordem);
+
+        free(m1);
+        free(m2);
+        free(mR);
+
+        return 0;
+    }
+
     printf("Matriz 1:\n");
     print_double_matrix(m1, ordem, ordem);
     printf("\n");
@@ -68,39 +991,92 @@ int main(int argc, char **argv)
     print_double_matrix(m2, ordem, ordem);
     printf("\n");
 
-    double *mR = (double *)malloc(sizeof(double) * ordem * ordem);
+    double *mR = alloc_double_matrix_first_touch(ordem, ordem, bloco_linhas);
+
+    // Modos float e misto: as entradas são convertidas para float fora da
+    // medição de tempo
+    int precisao_reduzida = strcmp(modo, "float") == 0 || strcmp(modo, "misto") == 0;
+    float *f1 = NULL, *f2 = NULL, *fR = NULL;
+    if (precisao_reduzida)
+    {
+        f1 = converter_para_float(m1, (long int)ordem * ordem, bloco_linhas * ordem);
+        f2 = converter_para_float(m2, (long int)ordem * ordem, bloco_linhas * ordem);
+        if (strcmp(modo, "float") == 0)
+            fR = (float *)malloc(sizeof(float) * ordem * ordem);
+    }
 
     // Início da medição de tempo
     double inicio = omp_get_wtime();
 
-    // Paralelizamos os dois loops externos (i e j)
-    // A diretiva collapse(2) funde os dois loops para melhor balanceamento de carga
-    #pragma omp parallel for collapse(2)
-    for (int i = 0; i < ordem; i++)
-    {
-        for (int j = 0; j < ordem; j++)
-        {
-            // Inicializa o elemento da matriz resultado
-            M(i, j, ordem, mR) = 0.0;
-
-            // Calcula o produto escalar da linha i de m1 pela coluna j de m2
-            // Este loop interno (k) não é paralelizado para evitar condições de corrida
-            for (int k = 0; k < ordem; k++)
-            {
-                M(i, j, ordem, mR) += M(i, k, ordem, m1) * M(k, j, ordem, m2);
-            }
-        }
-    }
+    if (strcmp(modo, "blocado") == 0)
+        multiplicacao_blocada(m1, m2, mR, ordem);
+    else if (strcmp(modo, "strassen") == 0)
+        multiplicacao_strassen(m1, m2, mR, ordem, corte);
+    else if (strcmp(modo, "float") == 0)
+        ppc_sgemm(ordem, ordem, ordem, 1.0f, f1, ordem, f2, ordem, 0.0f, fR, ordem);
+    else if (strcmp(modo, "misto") == 0)
+        ppc_dsgemm(ordem, ordem, ordem, 1.0, f1, ordem, f2, ordem, 0.0, mR, ordem);
+    else
+        multiplicacao_classica(m1, m2, mR, ordem, laco);
 
     // Fim da medição de tempo
     double fim = omp_get_wtime();
     double tempo_execucao = fim - inicio;
 
+    if (fR != NULL)
+    {
+        #pragma omp parallel for schedule(static)
+        for (long int i = 0; i < (long int)ordem * ordem; i++)
+            mR[i] = fR[i];
+    }
+
     printf("Matriz Resultado:\n");
     print_double_matrix(mR, ordem, ordem);
     printf("\n");
     printf("Tempo de execução (multiplicação): %.6f segundos\n", tempo_execucao);
 
+    if (strcmp(modo, "strassen") == 0 || precisao_reduzida)
+    {
+        // Strassen troca multiplicações por somas e os modos float e misto
+        // arredondam as entradas (e o float também as somas); todos perdem
+        // precisão. Compara com o produto convencional em double (GEMM
+        // blocado) para decidir se vale a pena
+        double *referencia = (double *)malloc(sizeof(double) * ordem * ordem);
+
+        double inicio_ref = omp_get_wtime();
+        multiplicacao_blocada(m1, m2, referencia, ordem);
+        double tempo_ref = omp_get_wtime() - inicio_ref;
+
+        double erro_max = 0.0, valor_max = 0.0;
+        for (long int i = 0; i < (long int)ordem * ordem; i++)
+        {
+            double erro = fabs(mR[i] - referencia[i]);
+            if (erro > erro_max)
+                erro_max = erro;
+            if (fabs(referencia[i]) > valor_max)
+                valor_max = fabs(referencia[i]);
+        }
+
+        double operacoes = 2.0 * ordem * ordem * (double)ordem;
+
+        printf("Desempenho: %.3f GFLOP/s\n", operacoes / tempo_execucao * 1e-9);
+        printf("Tempo do kernel convencional (blocado): %.6f segundos (%.3f GFLOP/s)\n",
+               tempo_ref, operacoes / tempo_ref * 1e-9);
+        printf("Erro máximo vs kernel convencional: %.6e (relativo: %.6e)\n",
+               erro_max, valor_max > 0.0 ? erro_max / valor_max : 0.0);
+
+        free(referencia);
+    }
+
+    free(f1);
+    free(f2);
+    free(fR);
+
+    printf("Páginas por nó NUMA:\n");
+    imprimir_distribuicao_numa("Matriz 1", m1, (long int)ordem * ordem);
+    imprimir_distribuicao_numa("Matriz 2", m2, (long int)ordem * ordem);
+    imprimir_distribuicao_numa("Matriz Resultado", mR, (long int)ordem * ordem);
+
     save_double_matrix(mR, ordem, ordem, "matrixmult_paralelo.out");
     printf("Matriz resultado salva em: matrixmult_paralelo.out\n");
 
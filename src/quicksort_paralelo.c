@@ -1,10 +1,36 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
 #include <unistd.h>
 #include <time.h>
 #include <omp.h>
 #include <libppc.h>
 
+// Tamanho mínimo de um subvetor para que suas metades virem tasks
+#define QUICKSORT_CORTE 1000
+
+// Tamanho a partir do qual a partição é feita em paralelo, por blocos
+#define LIMITE_PARTICAO_PARALELA (1L << 17)
+
+// Menor bloco da partição paralela, e blocos por thread (para equilibrar)
+#define BLOCO_PARTICAO 16384
+#define BLOCOS_POR_THREAD 4
+
+// Amostras por balde na escolha dos separadores do modo amostragem
+#define SOBREAMOSTRAGEM 64
+
+// Bits por dígito do modo radix (6 passadas de 11 bits) e chaves por buffer
+// de escrita (uma linha de cache)
+#define RADIX_BITS 11
+#define RADIX_BUFFER 8
+
+// Subvetores até este tamanho são ordenados por inserção (modos introsort e intercalacao)
+#define LIMITE_INSERCAO 16
+
+// A partir deste tamanho o pivô é a pseudomediana de 9 (ninther), e não a mediana de 3
+#define LIMITE_NINTHER 128
+
 void trocar_elementos(double *a, double *b)
 {
     double temp = *a;
@@ -29,36 +55,1030 @@ long int particao(double *vetor, long int low, long int high)
     return i + 1;
 }
 
+// Partição em 3 vias por blocos, em paralelo: cada task conta os elementos
+// < e == pivô do seu bloco, a soma de prefixos dessas contagens dá a posição
+// de cada bloco em cada uma das 3 partes, e cada task copia os seus
+// elementos para lá em auxiliar; depois auxiliar volta para vetor, também
+// por blocos. No fim vetor[low .. *menor_fim - 1] < pivô, vetor[*menor_fim ..
+// *maior_inicio - 1] == pivô e vetor[*maior_inicio .. high] > pivô. São
+// tasks (taskloop), e não um laço omp for, porque a partição é chamada de
+// dentro de uma task
+void particao_paralela(double *vetor, long int low, long int high, double pivo, double *auxiliar,
+                       long int *menor_fim, long int *maior_inicio)
+{
+    long int tamanho = high - low + 1;
+    long int blocos = (long int)omp_get_num_threads() * BLOCOS_POR_THREAD;
+
+    if (blocos > tamanho / BLOCO_PARTICAO)
+        blocos = tamanho / BLOCO_PARTICAO;
+    if (blocos < 1)
+        blocos = 1;
+
+    long int *menores = (long int *)malloc(sizeof(long int) * (blocos + 1));
+    long int *iguais = (long int *)malloc(sizeof(long int) * (blocos + 1));
+    long int *maiores = (long int *)malloc(sizeof(long int) * (blocos + 1));
+
+    #pragma omp taskloop grainsize(1) shared(vetor, menores, iguais, maiores)
+    for (long int b = 0; b < blocos; b++)
+    {
+        long int inicio = low + b * tamanho / blocos;
+        long int fim = low + (b + 1) * tamanho / blocos;
+        long int conta_menores = 0, conta_iguais = 0;
+
+        for (long int j = inicio; j < fim; j++)
+        {
+            conta_menores += vetor[j] < pivo;
+            conta_iguais += vetor[j] == pivo;
+        }
+
+        menores[b + 1] = conta_menores;
+        iguais[b + 1] = conta_iguais;
+        maiores[b + 1] = (fim - inicio) - conta_menores - conta_iguais;
+    }
+
+    // Soma de prefixos: o bloco b começa em menores[b], iguais[b] e maiores[b]
+    menores[0] = iguais[0] = maiores[0] = 0;
+    for (long int b = 0; b < blocos; b++)
+    {
+        menores[b + 1] += menores[b];
+        iguais[b + 1] += iguais[b];
+        maiores[b + 1] += maiores[b];
+    }
+
+    *menor_fim = low + menores[blocos];
+    *maior_inicio = *menor_fim + iguais[blocos];
+
+    long int inicio_iguais = *menor_fim, inicio_maiores = *maior_inicio;
+
+    #pragma omp taskloop grainsize(1) shared(vetor, auxiliar, menores, iguais, maiores)
+    for (long int b = 0; b < blocos; b++)
+    {
+        long int inicio = low + b * tamanho / blocos;
+        long int fim = low + (b + 1) * tamanho / blocos;
+        double *menor = &auxiliar[low + menores[b]];
+        double *igual = &auxiliar[inicio_iguais + iguais[b]];
+        double *maior = &auxiliar[inicio_maiores + maiores[b]];
+
+        for (long int j = inicio; j < fim; j++)
+        {
+            if (vetor[j] < pivo)
+                *menor++ = vetor[j];
+            else if (vetor[j] == pivo)
+                *igual++ = vetor[j];
+            else
+                *maior++ = vetor[j];
+        }
+    }
+
+    #pragma omp taskloop grainsize(1) shared(vetor, auxiliar)
+    for (long int b = 0; b < blocos; b++)
+    {
+        long int inicio = low + b * tamanho / blocos;
+        long int fim = low + (b + 1) * tamanho / blocos;
+
+        memcpy(&vetor[inicio], &auxiliar[inicio], sizeof(double) * (fim - inicio));
+    }
+
+    free(menores);
+    free(iguais);
+    free(maiores);
+}
+
+void ordenar_insercao(double *vetor, long int low, long int high)
+{
+    for (long int i = low + 1; i <= high; i++)
+    {
+        double valor = vetor[i];
+        long int j = i - 1;
+
+        while (j >= low && vetor[j] > valor)
+        {
+            vetor[j + 1] = vetor[j];
+            j--;
+        }
+        vetor[j + 1] = valor;
+    }
+}
+
+// Desce vetor[base + raiz] no heap de máximo vetor[base .. base + tamanho - 1]
+void descer_heap(double *vetor, long int base, long int raiz, long int tamanho)
+{
+    double valor = vetor[base + raiz];
+
+    while (2 * raiz + 1 < tamanho)
+    {
+        long int filho = 2 * raiz + 1;
+
+        if (filho + 1 < tamanho && vetor[base + filho + 1] > vetor[base + filho])
+            filho++;
+        if (vetor[base + filho] <= valor)
+            break;
+
+        vetor[base + raiz] = vetor[base + filho];
+        raiz = filho;
+    }
+    vetor[base + raiz] = valor;
+}
+
+void heapsort(double *vetor, long int low, long int high)
+{
+    long int tamanho = high - low + 1;
+
+    for (long int i = tamanho / 2 - 1; i >= 0; i--)
+        descer_heap(vetor, low, i, tamanho);
+
+    for (long int fim = tamanho - 1; fim > 0; fim--)
+    {
+        trocar_elementos(&vetor[low], &vetor[low + fim]);
+        descer_heap(vetor, low, 0, fim);
+    }
+}
+
+double mediana_de_tres(double a, double b, double c)
+{
+    if (a < b)
+        return (b < c) ? b : (a < c) ? c : a;
+    return (a < c) ? a : (b < c) ? c : b;
+}
+
+// Mediana de 3 (início, meio e fim), ou, em subvetores grandes, a mediana
+// das medianas de 3 trios espalhados (ninther de Tukey): um vetor já
+// ordenado, invertido ou em "dente de serra" não dá mais o pior pivô
+double escolher_pivo(const double *vetor, long int low, long int high)
+{
+    long int meio = low + (high - low) / 2;
+
+    if (high - low + 1 < LIMITE_NINTHER)
+        return mediana_de_tres(vetor[low], vetor[meio], vetor[high]);
+
+    long int passo = (high - low + 1) / 8;
+
+    return mediana_de_tres(
+        mediana_de_tres(vetor[low], vetor[low + passo], vetor[low + 2 * passo]),
+        mediana_de_tres(vetor[meio - passo], vetor[meio], vetor[meio + passo]),
+        mediana_de_tres(vetor[high - 2 * passo], vetor[high - passo], vetor[high]));
+}
+
+// Partição em 3 vias de Bentley e McIlroy: varre dos dois lados como a de
+// Hoare, trocando só os pares fora do lugar, e guarda os iguais ao pivô
+// nas pontas, levados para o meio no fim. Resultado: vetor[low ..
+// *menor_fim - 1] < pivô, vetor[*menor_fim .. *maior_inicio - 1] == pivô e
+// vetor[*maior_inicio .. high] > pivô. Os iguais saem da recursão, então
+// valores repetidos deixam a ordenação mais rápida, e não O(n²)
+void particao_tres_vias(double *vetor, long int low, long int high, double pivo,
+                        long int *menor_fim, long int *maior_inicio)
+{
+    long int a = low, b = low, c = high, d = high;
+
+    for (;;)
+    {
+        while (b <= c && vetor[b] <= pivo)
+        {
+            if (vetor[b] == pivo)
+                trocar_elementos(&vetor[a++], &vetor[b]);
+            b++;
+        }
+        while (c >= b && vetor[c] >= pivo)
+        {
+            if (vetor[c] == pivo)
+                trocar_elementos(&vetor[c], &vetor[d--]);
+            c--;
+        }
+        if (b > c)
+            break;
+        trocar_elementos(&vetor[b++], &vetor[c--]);
+    }
+
+    // Iguais de vetor[low .. a - 1] e vetor[d + 1 .. high] para o meio
+    long int n = (a - low < b - a) ? a - low : b - a;
+    for (long int k = 0; k < n; k++)
+        trocar_elementos(&vetor[low + k], &vetor[b - n + k]);
+
+    n = (d - c < high - d) ? d - c : high - d;
+    for (long int k = 0; k < n; k++)
+        trocar_elementos(&vetor[b + k], &vetor[high - n + 1 + k]);
+
+    *menor_fim = low + (b - a);
+    *maior_inicio = high - (d - c) + 1;
+}
+
+// Profundidade máxima da recursão do introsort, 2 log2(tamanho)
+int limite_profundidade(long int tamanho)
+{
+    int limite = 0;
 
-void quicksort_parallel(double *vetor, long int low, long int high, int depth)
+    while (tamanho > 1)
+    {
+        tamanho >>= 1;
+        limite += 2;
+    }
+
+    return limite;
+}
+
+// auxiliar (do tamanho do vetor, ou NULL) habilita a partição paralela nos
+// níveis que criam tasks, enquanto o subvetor passa de LIMITE_PARTICAO_PARALELA;
+// abaixo disso a partição é a sequencial
+void quicksort_parallel(double *vetor, long int low, long int high, int depth, long int corte, double *auxiliar)
 {
     if (low < high)
     {
-        long int pi = particao(vetor, low, high);
-        if (depth > 0 && (high - low) > 1000)
+        long int pi;
+
+        // Com o pivô de particao(), o último dos iguais fica no lugar dele
+        if (auxiliar != NULL && depth > 0 && high - low > LIMITE_PARTICAO_PARALELA)
+        {
+            long int menor_fim, maior_inicio;
+            particao_paralela(vetor, low, high, vetor[high], auxiliar, &menor_fim, &maior_inicio);
+            pi = maior_inicio - 1;
+        }
+        else
+            pi = particao(vetor, low, high);
+
+        if (depth > 0 && (high - low) > corte)
+        {
+            #pragma omp task shared(vetor)
+            quicksort_parallel(vetor, low, pi - 1, depth - 1, corte, auxiliar);
+
+            #pragma omp task shared(vetor)
+            quicksort_parallel(vetor, pi + 1, high, depth - 1, corte, auxiliar);
+
+            #pragma omp taskwait
+        }
+        else
+        {
+            quicksort_parallel(vetor, low, pi - 1, depth - 1, corte, auxiliar);
+            quicksort_parallel(vetor, pi + 1, high, depth - 1, corte, auxiliar);
+        }
+    }
+}
+
+// Introsort paralelo: o introsort do quicksort_serial (pivô por mediana,
+// partição em 3 vias, heapsort além de 2 log2(n) níveis e inserção nos
+// subvetores pequenos), com as duas partes em tasks nos primeiros depth
+// níveis e a partição paralela nos subvetores grandes desses níveis
+void introsort_paralelo(double *vetor, long int low, long int high, int profundidade, int depth, long int corte,
+                        double *auxiliar)
+{
+    while (high - low + 1 > LIMITE_INSERCAO)
+    {
+        if (profundidade == 0)
+        {
+            heapsort(vetor, low, high);
+            return;
+        }
+        profundidade--;
+
+        long int menor_fim, maior_inicio;
+        double pivo = escolher_pivo(vetor, low, high);
+
+        if (auxiliar != NULL && depth > 0 && high - low > LIMITE_PARTICAO_PARALELA)
+            particao_paralela(vetor, low, high, pivo, auxiliar, &menor_fim, &maior_inicio);
+        else
+            particao_tres_vias(vetor, low, high, pivo, &menor_fim, &maior_inicio);
+
+        if (depth > 0 && high - low > corte)
         {
             #pragma omp task shared(vetor)
-            quicksort_parallel(vetor, low, pi - 1, depth - 1);
+            introsort_paralelo(vetor, low, menor_fim - 1, profundidade, depth - 1, corte, auxiliar);
 
             #pragma omp task shared(vetor)
-            quicksort_parallel(vetor, pi + 1, high, depth - 1);
+            introsort_paralelo(vetor, maior_inicio, high, profundidade, depth - 1, corte, auxiliar);
 
             #pragma omp taskwait
+            return;
+        }
+
+        // Recursão na parte menor, laço na maior: a pilha fica em log2(n)
+        if (menor_fim - low < high - maior_inicio + 1)
+        {
+            introsort_paralelo(vetor, low, menor_fim - 1, profundidade, depth, corte, auxiliar);
+            low = maior_inicio;
         }
         else
         {
-            quicksort_parallel(vetor, low, pi - 1, depth - 1);
-            quicksort_parallel(vetor, pi + 1, high, depth - 1);
+            introsort_paralelo(vetor, maior_inicio, high, profundidade, depth, corte, auxiliar);
+            high = menor_fim - 1;
+        }
+    }
+
+    ordenar_insercao(vetor, low, high);
+}
+
+// Ordena o vetor inteiro, criando tasks por log2(threads) + profundidade_extra
+// níveis da recursão; introsort escolhe introsort_paralelo no lugar do
+// quicksort clássico
+void ordenar_paralelo(double *vetor, long int tamanho, long int corte, int profundidade_extra, int introsort)
+{
+    int max_depth = 0;
+    int num_threads = omp_get_max_threads();
+    while ((1 << max_depth) < num_threads)
+    {
+        max_depth++;
+    }
+    max_depth += profundidade_extra;
+
+    // Com uma thread não há com quem dividir a partição
+    double *auxiliar = NULL;
+    if (num_threads > 1 && tamanho > LIMITE_PARTICAO_PARALELA)
+        auxiliar = (double *)malloc(sizeof(double) * tamanho);
+
+    #pragma omp parallel
+    {
+        #pragma omp single
+        {
+            if (introsort)
+                introsort_paralelo(vetor, 0, tamanho - 1, limite_profundidade(tamanho), max_depth, corte, auxiliar);
+            else
+                quicksort_parallel(vetor, 0, tamanho - 1, max_depth, corte, auxiliar);
+        }
+    }
+
+    free(auxiliar);
+}
+
+// Balde de valor: quantos separadores são <= valor (busca binária)
+static inline int escolher_balde(const double *separadores, int num_separadores, double valor)
+{
+    int inicio = 0, fim = num_separadores;
+
+    while (inicio < fim)
+    {
+        int meio = (inicio + fim) / 2;
+        if (separadores[meio] <= valor)
+            inicio = meio + 1;
+        else
+            fim = meio;
+    }
+
+    return inicio;
+}
+
+// Sample sort: uma amostra de SOBREAMOSTRAGEM elementos por balde, ordenada,
+// dá os separadores de um balde por thread; cada thread classifica o seu
+// trecho do vetor nos baldes e conta quantos elementos foram para cada um, a
+// soma de prefixos das contagens (balde a balde, e thread a thread dentro do
+// balde) dá onde cada thread escreve, e uma única passada espalha o vetor em
+// auxiliar. Depois cada balde é ordenado pelo introsort e volta para vetor.
+// Os baldes não se sobrepõem (os iguais aos separadores ficam todos no mesmo),
+// então o resultado é o mesmo de qualquer outra ordenação
+void ordenar_amostragem(double *vetor, long int tamanho)
+{
+    int max_baldes = omp_get_max_threads();
+
+    if (max_baldes == 1 || tamanho < (long int)max_baldes * SOBREAMOSTRAGEM)
+    {
+        introsort_paralelo(vetor, 0, tamanho - 1, limite_profundidade(tamanho), 0, 0, NULL);
+        return;
+    }
+
+    // Vetores para o maior número de baldes; os usados são os da equipe
+    double *amostra = (double *)malloc(sizeof(double) * max_baldes * SOBREAMOSTRAGEM);
+    double *separadores = (double *)malloc(sizeof(double) * max_baldes);
+    double *auxiliar = (double *)malloc(sizeof(double) * tamanho);
+    unsigned short *balde = (unsigned short *)malloc(sizeof(unsigned short) * tamanho);
+    long int *contadores = (long int *)calloc((size_t)max_baldes * max_baldes, sizeof(long int));
+    long int *inicio_balde = (long int *)malloc(sizeof(long int) * (max_baldes + 1));
+    int num_baldes = 1;
+
+    #pragma omp parallel num_threads(max_baldes)
+    {
+        // A equipe pode ter menos threads que o pedido (OMP_THREAD_LIMIT,
+        // OMP_DYNAMIC): um balde e um trecho por thread que de fato existe
+        #pragma omp single
+        {
+            num_baldes = omp_get_num_threads();
+
+            // Amostra em posições pseudoaleatórias, com semente fixa
+            int num_amostras = num_baldes * SOBREAMOSTRAGEM;
+            unsigned int semente = 23;
+
+            for (int i = 0; i < num_amostras; i++)
+                amostra[i] = vetor[(long int)(((double)rand_r(&semente) / ((double)RAND_MAX + 1.0)) * tamanho)];
+
+            introsort_paralelo(amostra, 0, num_amostras - 1, limite_profundidade(num_amostras), 0, 0, NULL);
+
+            for (int b = 1; b < num_baldes; b++)
+                separadores[b - 1] = amostra[b * SOBREAMOSTRAGEM];
+        }
+
+        int t = omp_get_thread_num();
+        long int *contador = &contadores[(long int)t * num_baldes];
+        long int inicio = tamanho * t / num_baldes;
+        long int fim = tamanho * (t + 1) / num_baldes;
+
+        // Classificação: o balde de cada elemento é guardado, para não
+        // repetir a busca na distribuição
+        for (long int i = inicio; i < fim; i++)
+        {
+            int b = escolher_balde(separadores, num_baldes - 1, vetor[i]);
+            balde[i] = (unsigned short)b;
+            contador[b]++;
+        }
+
+        #pragma omp barrier
+
+        // Posição de escrita de cada (thread, balde)
+        #pragma omp single
+        {
+            long int posicao = 0;
+
+            for (int b = 0; b < num_baldes; b++)
+            {
+                inicio_balde[b] = posicao;
+                for (int u = 0; u < num_baldes; u++)
+                {
+                    long int quantidade = contadores[(long int)u * num_baldes + b];
+                    contadores[(long int)u * num_baldes + b] = posicao;
+                    posicao += quantidade;
+                }
+            }
+            inicio_balde[num_baldes] = posicao;
+        }
+
+        for (long int i = inicio; i < fim; i++)
+            auxiliar[contador[balde[i]]++] = vetor[i];
+
+        #pragma omp barrier
+
+        #pragma omp for schedule(dynamic, 1)
+        for (int b = 0; b < num_baldes; b++)
+        {
+            long int low = inicio_balde[b];
+            long int high = inicio_balde[b + 1] - 1;
+
+            if (low <= high)
+            {
+                introsort_paralelo(auxiliar, low, high, limite_profundidade(high - low + 1), 0, 0, NULL);
+                memcpy(&vetor[low], &auxiliar[low], sizeof(double) * (high - low + 1));
+            }
         }
     }
+
+    free(amostra);
+    free(separadores);
+    free(auxiliar);
+    free(balde);
+    free(contadores);
+    free(inicio_balde);
+}
+
+// Intercala origem[low .. meio - 1] e origem[meio .. high - 1], já ordenados,
+// em destino[low .. high - 1]; nos empates vem primeiro o da esquerda (estável)
+void intercalar(const double *origem, double *destino, long int low, long int meio, long int high)
+{
+    long int i = low, j = meio, k = low;
+
+    while (i < meio && j < high)
+        destino[k++] = (origem[j] < origem[i]) ? origem[j++] : origem[i++];
+    while (i < meio)
+        destino[k++] = origem[i++];
+    while (j < high)
+        destino[k++] = origem[j++];
+}
+
+// Merge sort estável de vetor[low .. high], de baixo para cima: blocos de
+// LIMITE_INSERCAO elementos por inserção, e passadas de intercalação que
+// alternam entre vetor e auxiliar (nas mesmas posições), em acessos
+// sequenciais; o resultado fica em vetor
+void ordenar_intercalacao(double *vetor, double *auxiliar, long int low, long int high)
+{
+    long int fim = high + 1;
+
+    for (long int i = low; i < fim; i += LIMITE_INSERCAO)
+        ordenar_insercao(vetor, i, ((i + LIMITE_INSERCAO < fim) ? i + LIMITE_INSERCAO : fim) - 1);
+
+    double *origem = vetor, *destino = auxiliar;
+
+    for (long int largura = LIMITE_INSERCAO; largura < fim - low; largura *= 2)
+    {
+        for (long int i = low; i < fim; i += 2 * largura)
+        {
+            long int meio = (i + largura < fim) ? i + largura : fim;
+            long int final = (i + 2 * largura < fim) ? i + 2 * largura : fim;
+            intercalar(origem, destino, i, meio, final);
+        }
+
+        double *temp = origem;
+        origem = destino;
+        destino = temp;
+    }
+
+    if (origem != vetor)
+        memcpy(&vetor[low], &origem[low], sizeof(double) * (fim - low));
+}
+
+// Primeira posição de vetor[inicio .. fim - 1], ordenado, com valor >= valor
+long int limite_inferior(const double *vetor, long int inicio, long int fim, double valor)
+{
+    while (inicio < fim)
+    {
+        long int meio = inicio + (fim - inicio) / 2;
+        if (vetor[meio] < valor)
+            inicio = meio + 1;
+        else
+            fim = meio;
+    }
+
+    return inicio;
+}
+
+// Primeira posição de vetor[inicio .. fim - 1], ordenado, com valor > valor
+long int limite_superior(const double *vetor, long int inicio, long int fim, double valor)
+{
+    while (inicio < fim)
+    {
+        long int meio = inicio + (fim - inicio) / 2;
+        if (valor < vetor[meio])
+            fim = meio;
+        else
+            inicio = meio + 1;
+    }
+
+    return inicio;
+}
+
+// Posição de vetor[k], da sequência s, na intercalação estável das sequências
+// ordenadas vetor[inicio[u] .. inicio[u + 1] - 1]: vêm antes dele os menores
+// de todas as sequências, os iguais das sequências anteriores a s e os
+// anteriores a ele em s
+long int posto_estavel(const double *vetor, const long int *inicio, int num_sequencias, int s, long int k)
+{
+    long int posto = k - inicio[s];
+
+    for (int u = 0; u < num_sequencias; u++)
+    {
+        if (u < s)
+            posto += limite_superior(vetor, inicio[u], inicio[u + 1], vetor[k]) - inicio[u];
+        else if (u > s)
+            posto += limite_inferior(vetor, inicio[u], inicio[u + 1], vetor[k]) - inicio[u];
+    }
+
+    return posto;
+}
+
+// Co-ranking exato: corte[u] de cada sequência tal que os primeiros posto
+// elementos da intercalação estável são vetor[inicio[u] .. corte[u] - 1].
+// Acha, por busca binária em cada sequência, o elemento que fica na posição
+// posto, e corta as outras sequências no valor dele
+void cortar_sequencias(const double *vetor, const long int *inicio, int num_sequencias, long int posto,
+                       long int *corte)
+{
+    for (int s = 0; s < num_sequencias; s++)
+    {
+        long int a = inicio[s], b = inicio[s + 1];
+
+        // Primeiro elemento de s com posto >= posto (o posto cresce em s)
+        while (a < b)
+        {
+            long int meio = a + (b - a) / 2;
+            if (posto_estavel(vetor, inicio, num_sequencias, s, meio) < posto)
+                a = meio + 1;
+            else
+                b = meio;
+        }
+
+        if (a < inicio[s + 1] && posto_estavel(vetor, inicio, num_sequencias, s, a) == posto)
+        {
+            for (int u = 0; u < num_sequencias; u++)
+            {
+                if (u < s)
+                    corte[u] = limite_superior(vetor, inicio[u], inicio[u + 1], vetor[a]);
+                else if (u > s)
+                    corte[u] = limite_inferior(vetor, inicio[u], inicio[u + 1], vetor[a]);
+                else
+                    corte[u] = a;
+            }
+            return;
+        }
+    }
+
+    // posto é o total: as sequências inteiras
+    for (int u = 0; u < num_sequencias; u++)
+        corte[u] = inicio[u + 1];
+}
+
+// A cabeça da sequência a vem antes da cabeça da b: menor valor, ou mesmo
+// valor e sequência anterior (estável); uma sequência esgotada vem depois
+static inline int vem_antes(const double *vetor, const long int *cabeca, const long int *fim, int a, int b)
+{
+    if (cabeca[a] == fim[a])
+        return 0;
+    if (cabeca[b] == fim[b])
+        return 1;
+    if (vetor[cabeca[a]] != vetor[cabeca[b]])
+        return vetor[cabeca[a]] < vetor[cabeca[b]];
+    return a < b;
+}
+
+// Monta a subárvore de perdedores de no; devolve o vencedor dela
+int montar_arvore(const double *vetor, const long int *cabeca, const long int *fim, int *arvore,
+                  int folhas, int no)
+{
+    if (no >= folhas)
+        return no - folhas;
+
+    int esquerda = montar_arvore(vetor, cabeca, fim, arvore, folhas, 2 * no);
+    int direita = montar_arvore(vetor, cabeca, fim, arvore, folhas, 2 * no + 1);
+
+    if (vem_antes(vetor, cabeca, fim, esquerda, direita))
+    {
+        arvore[no] = direita;
+        return esquerda;
+    }
+    arvore[no] = esquerda;
+    return direita;
+}
+
+// Intercalação estável das sequências vetor[de[u] .. ate[u] - 1] em destino,
+// com uma árvore de perdedores: cada nó interno guarda a sequência que perdeu
+// a comparação ali, e cada elemento de saída custa log2(sequências)
+// comparações, só no caminho da folha do vencedor até a raiz
+void intercalar_sequencias(const double *vetor, const long int *de, const long int *ate, int num_sequencias,
+                           double *destino)
+{
+    int folhas = 1;
+    while (folhas < num_sequencias)
+        folhas *= 2;
+
+    // As folhas além de num_sequencias são sequências vazias
+    long int *cabeca = (long int *)calloc(folhas, sizeof(long int));
+    long int *fim = (long int *)calloc(folhas, sizeof(long int));
+    int *arvore = (int *)malloc(sizeof(int) * folhas);
+    long int total = 0;
+
+    for (int u = 0; u < num_sequencias; u++)
+    {
+        cabeca[u] = de[u];
+        fim[u] = ate[u];
+        total += ate[u] - de[u];
+    }
+
+    int vencedor = montar_arvore(vetor, cabeca, fim, arvore, folhas, 1);
+
+    for (long int k = 0; k < total; k++)
+    {
+        destino[k] = vetor[cabeca[vencedor]++];
+
+        for (int no = (vencedor + folhas) / 2; no >= 1; no /= 2)
+        {
+            if (vem_antes(vetor, cabeca, fim, arvore[no], vencedor))
+            {
+                int perdedor = vencedor;
+                vencedor = arvore[no];
+                arvore[no] = perdedor;
+            }
+        }
+    }
+
+    free(cabeca);
+    free(fim);
+    free(arvore);
+}
+
+// Merge sort paralelo em múltiplas vias: cada thread ordena o seu trecho
+// (ordenar_intercalacao, estável), o co-ranking exato corta os trechos
+// ordenados para que cada thread intercale a mesma quantidade da saída, e
+// cada thread intercala a sua parte com uma árvore de perdedores. Estável,
+// O(n log n) qualquer que seja a entrada, e com acessos sequenciais
+void ordenar_multiplas_vias(double *vetor, long int tamanho)
+{
+    int max_sequencias = omp_get_max_threads();
+    double *auxiliar = (double *)malloc(sizeof(double) * tamanho);
+
+    if (max_sequencias == 1 || tamanho < (long int)max_sequencias * LIMITE_INSERCAO)
+    {
+        ordenar_intercalacao(vetor, auxiliar, 0, tamanho - 1);
+        free(auxiliar);
+        return;
+    }
+
+    // Vetores para o maior número de sequências; as usadas são as da equipe
+    long int *inicio = (long int *)malloc(sizeof(long int) * (max_sequencias + 1));
+    long int *cortes = (long int *)malloc(sizeof(long int) * (max_sequencias + 1) * max_sequencias);
+    int num_sequencias = 1;
+
+    #pragma omp parallel num_threads(max_sequencias)
+    {
+        // A equipe pode ter menos threads que o pedido (OMP_THREAD_LIMIT,
+        // OMP_DYNAMIC): uma sequência por thread que de fato existe
+        #pragma omp single
+        {
+            num_sequencias = omp_get_num_threads();
+            for (int t = 0; t <= num_sequencias; t++)
+                inicio[t] = tamanho * t / num_sequencias;
+        }
+
+        int t = omp_get_thread_num();
+
+        ordenar_intercalacao(vetor, auxiliar, inicio[t], inicio[t + 1] - 1);
+
+        #pragma omp barrier
+
+        // A thread t escreve as posições inicio[t] .. inicio[t + 1] - 1 da saída
+        cortar_sequencias(vetor, inicio, num_sequencias, inicio[t], &cortes[(long int)t * num_sequencias]);
+        if (t == 0)
+            cortar_sequencias(vetor, inicio, num_sequencias, tamanho,
+                              &cortes[(long int)num_sequencias * num_sequencias]);
+
+        #pragma omp barrier
+
+        intercalar_sequencias(vetor, &cortes[(long int)t * num_sequencias],
+                              &cortes[(long int)(t + 1) * num_sequencias], num_sequencias, &auxiliar[inicio[t]]);
+
+        #pragma omp barrier
+
+        memcpy(&vetor[inicio[t]], &auxiliar[inicio[t]], sizeof(double) * (inicio[t + 1] - inicio[t]));
+    }
+
+    free(inicio);
+    free(cortes);
+    free(auxiliar);
+}
+
+// Chave inteira de valor, na mesma ordem: sem sinal, só o bit de sinal é
+// ligado; com sinal, todos os bits são invertidos (os negativos ficam antes e
+// com a ordem invertida). A ordem fica -NaN < -inf < ... < -0.0 < 0.0 < ... <
+// inf < NaN
+static inline uint64_t chave_radix(double valor)
+{
+    uint64_t bits;
+
+    memcpy(&bits, &valor, sizeof(bits));
+    return (bits & (1ULL << 63)) ? ~bits : bits | (1ULL << 63);
+}
+
+static inline double valor_radix(uint64_t chave)
+{
+    uint64_t bits = (chave & (1ULL << 63)) ? chave & ~(1ULL << 63) : ~chave;
+    double valor;
+
+    memcpy(&valor, &bits, sizeof(valor));
+    return valor;
+}
+
+// Radix sort LSD paralelo: o vetor vira chaves inteiras (chave_radix), que
+// são ordenadas por dígitos de RADIX_BITS bits, do menos para o mais
+// significativo, alternando entre dois vetores de chaves. Em cada passada,
+// cada thread conta os dígitos do seu trecho, a soma de prefixos das
+// contagens (dígito a dígito, e thread a thread dentro do dígito) dá onde
+// cada thread escreve cada dígito, e cada thread espalha o seu trecho. A
+// escrita passa por buffers de uma linha de cache por dígito, copiados
+// inteiros para o destino (write-combining). As passadas em que todas as
+// chaves têm o mesmo dígito são puladas
+void ordenar_radix(double *vetor, long int tamanho)
+{
+    int max_threads = omp_get_max_threads();
+    int num_threads = 1;
+    int num_passadas = (64 + RADIX_BITS - 1) / RADIX_BITS;
+    long int baldes = 1L << RADIX_BITS;
+
+    uint64_t *chaves = (uint64_t *)malloc(sizeof(uint64_t) * tamanho);
+    uint64_t *auxiliar = (uint64_t *)malloc(sizeof(uint64_t) * tamanho);
+
+    // contadores[t][p][d]: chaves do trecho da thread t com dígito d na
+    // passada p; depois, onde a thread t escreve o dígito d. Alocados para o
+    // maior número de threads; os usados são os da equipe
+    long int *contadores = (long int *)calloc((size_t)max_threads * num_passadas * baldes, sizeof(long int));
+    long int *totais = (long int *)malloc(sizeof(long int) * baldes);
+    int *pular = (int *)malloc(sizeof(int) * num_passadas);
+
+    #pragma omp parallel num_threads(max_threads)
+    {
+        // A equipe pode ter menos threads que o pedido (OMP_THREAD_LIMIT,
+        // OMP_DYNAMIC): um trecho por thread que de fato existe
+        #pragma omp single
+        num_threads = omp_get_num_threads();
+
+        int t = omp_get_thread_num();
+        long int inicio = tamanho * t / num_threads;
+        long int fim = tamanho * (t + 1) / num_threads;
+        long int *contador = &contadores[(long int)t * num_passadas * baldes];
+
+        // Buffers de write-combining, alinhados à linha de cache
+        uint64_t *buffer = (uint64_t *)aligned_alloc(64, sizeof(uint64_t) * baldes * RADIX_BUFFER);
+        int *ocupados = (int *)malloc(sizeof(int) * baldes);
+
+        // Transformação e contagem de todos os dígitos, em uma leitura
+        for (long int i = inicio; i < fim; i++)
+        {
+            uint64_t chave = chave_radix(vetor[i]);
+            chaves[i] = chave;
+            for (int p = 0; p < num_passadas; p++)
+                contador[p * baldes + ((chave >> (p * RADIX_BITS)) & (baldes - 1))]++;
+        }
+
+        #pragma omp barrier
+
+        // Uma passada é pulada se um dígito tem todas as chaves
+        #pragma omp for
+        for (int p = 0; p < num_passadas; p++)
+        {
+            pular[p] = 0;
+            for (long int d = 0; d < baldes && !pular[p]; d++)
+            {
+                long int soma = 0;
+                for (int u = 0; u < num_threads; u++)
+                    soma += contadores[((long int)u * num_passadas + p) * baldes + d];
+                pular[p] = (soma == tamanho);
+            }
+        }
+
+        uint64_t *origem = chaves, *destino = auxiliar;
+        int contagem_valida = 1;
+
+        for (int p = 0; p < num_passadas; p++)
+        {
+            if (pular[p])
+                continue;
+
+            int deslocamento = p * RADIX_BITS;
+            long int *posicao = &contador[p * baldes];
+
+            // Depois da primeira passada feita, o trecho tem outras chaves
+            if (!contagem_valida)
+            {
+                memset(posicao, 0, sizeof(long int) * baldes);
+                for (long int i = inicio; i < fim; i++)
+                    posicao[(origem[i] >> deslocamento) & (baldes - 1)]++;
+            }
+            contagem_valida = 0;
+
+            #pragma omp barrier
+
+            // Soma de prefixos: total de cada dígito, em paralelo ...
+            #pragma omp for
+            for (long int d = 0; d < baldes; d++)
+            {
+                long int soma = 0;
+                for (int u = 0; u < num_threads; u++)
+                    soma += contadores[((long int)u * num_passadas + p) * baldes + d];
+                totais[d] = soma;
+            }
+
+            // ... início de cada dígito ...
+            #pragma omp single
+            {
+                long int soma = 0;
+                for (long int d = 0; d < baldes; d++)
+                {
+                    long int quantidade = totais[d];
+                    totais[d] = soma;
+                    soma += quantidade;
+                }
+            }
+
+            // ... e início de cada thread em cada dígito, em paralelo
+            #pragma omp for
+            for (long int d = 0; d < baldes; d++)
+            {
+                long int soma = totais[d];
+                for (int u = 0; u < num_threads; u++)
+                {
+                    long int *celula = &contadores[((long int)u * num_passadas + p) * baldes + d];
+                    long int quantidade = *celula;
+                    *celula = soma;
+                    soma += quantidade;
+                }
+            }
+
+            // Distribuição, por linhas de cache inteiras
+            memset(ocupados, 0, sizeof(int) * baldes);
+            for (long int i = inicio; i < fim; i++)
+            {
+                uint64_t chave = origem[i];
+                long int d = (chave >> deslocamento) & (baldes - 1);
+                uint64_t *linha = &buffer[d * RADIX_BUFFER];
+
+                linha[ocupados[d]++] = chave;
+                if (ocupados[d] == RADIX_BUFFER)
+                {
+                    memcpy(&destino[posicao[d]], linha, sizeof(uint64_t) * RADIX_BUFFER);
+                    posicao[d] += RADIX_BUFFER;
+                    ocupados[d] = 0;
+                }
+            }
+            for (long int d = 0; d < baldes; d++)
+            {
+                memcpy(&destino[posicao[d]], &buffer[d * RADIX_BUFFER], sizeof(uint64_t) * ocupados[d]);
+                posicao[d] += ocupados[d];
+            }
+
+            #pragma omp barrier
+
+            uint64_t *temp = origem;
+            origem = destino;
+            destino = temp;
+        }
+
+        for (long int i = inicio; i < fim; i++)
+            vetor[i] = valor_radix(origem[i]);
+
+        free(buffer);
+        free(ocupados);
+    }
+
+    free(chaves);
+    free(auxiliar);
+    free(contadores);
+    free(totais);
+    free(pular);
+}
+
+// Ordenação medida pelo autotune: cada medição ordena uma cópia nova do
+// vetor original, com o corte e a profundidade extra de tasks dados
+typedef struct
+{
+    const double *original;
+    double *copia;
+    long int tamanho;
+    long int corte;
+    int profundidade_extra;
+} medicao_ordenacao;
+
+void restaurar_copia(void *contexto)
+{
+    medicao_ordenacao *medicao = (medicao_ordenacao *)contexto;
+
+    memcpy(medicao->copia, medicao->original, sizeof(double) * medicao->tamanho);
+}
+
+void executar_medicao(void *contexto)
+{
+    medicao_ordenacao *medicao = (medicao_ordenacao *)contexto;
+
+    ordenar_paralelo(medicao->copia, medicao->tamanho, medicao->corte, medicao->profundidade_extra, 0);
+}
+
+// Menor tempo de algumas ordenações de cópias do vetor original
+double medir_ordenacao(const double *original, double *copia, long int tamanho,
+                       long int corte, int profundidade_extra)
+{
+    medicao_ordenacao medicao = {original, copia, tamanho, corte, profundidade_extra};
+
+    return ppc_profile_time(restaurar_copia, executar_medicao, &medicao);
+}
+
+// Modo autotune: escolhe o corte para criar tasks, a profundidade extra de
+// tasks e o número de threads para este tamanho e grava no perfil
+void autoajustar(const double *original, long int tamanho)
+{
+    const long int opcoes_corte[] = {100, 300, 1000, 3000, 10000, 30000, 100000};
+    int max_threads = omp_get_max_threads();
+    double *copia = (double *)malloc(sizeof(double) * tamanho);
+    double tempo, melhor_tempo;
+    long int corte = QUICKSORT_CORTE;
+    int profundidade_extra = 0;
+
+    printf("Autoajuste do corte (%d threads):\n", max_threads);
+    melhor_tempo = -1.0;
+    for (unsigned i = 0; i < sizeof(opcoes_corte) / sizeof(opcoes_corte[0]); i++)
+    {
+        tempo = medir_ordenacao(original, copia, tamanho, opcoes_corte[i], 0);
+        printf("  corte=%ld: %.6f s\n", opcoes_corte[i], tempo);
+        if (melhor_tempo < 0.0 || tempo < melhor_tempo)
+        {
+            melhor_tempo = tempo;
+            corte = opcoes_corte[i];
+        }
+    }
+
+    printf("\nAutoajuste da profundidade de tasks:\n");
+    melhor_tempo = -1.0;
+    for (int extra = 0; extra <= 4; extra++)
+    {
+        tempo = medir_ordenacao(original, copia, tamanho, corte, extra);
+        printf("  log2(threads) + %d: %.6f s\n", extra, tempo);
+        if (melhor_tempo < 0.0 || tempo < melhor_tempo)
+        {
+            melhor_tempo = tempo;
+            profundidade_extra = extra;
+        }
+    }
+
+    // Sem fixar as threads em CPUs, como nas ordenações do programa
+    printf("\nAutoajuste do número de threads:\n");
+    medicao_ordenacao medicao = {original, copia, tamanho, corte, profundidade_extra};
+    int threads = ppc_profile_tune_threads(restaurar_copia, executar_medicao, &medicao, 0);
+
+    ppc_profile_set("quicksort_corte", tamanho, corte);
+    ppc_profile_set("quicksort_profundidade_extra", tamanho, profundidade_extra);
+    ppc_profile_set("quicksort_threads", tamanho, threads);
+
+    printf("\nMelhores parâmetros para tamanho %ld:\n", tamanho);
+    printf("  corte=%ld profundidade extra=%d threads=%d\n", corte, profundidade_extra, threads);
+    printf("Perfil salvo em: %s\n", ppc_profile_filename());
+
+    free(copia);
 }
 
 int main(int argc, char **argv)
 {
     // Valida argumentos passados via terminal
-    if (argc != 3)
+    if (argc < 3 || argc > 4)
     {
-        fprintf(stderr, "Uso: %s <tamanho> <arquivo_vetor>\n", argv[0]);
+        fprintf(stderr, "Uso: %s <tamanho> <arquivo_vetor> [modo]\n", argv[0]);
+        fprintf(stderr, "Modos: classico (padrão), introsort, amostragem, intercalacao, radix, autotune\n");
         fprintf(stderr, "Exemplo: %s 10 vetor.in\n", argv[0]);
         return 1;
     }
@@ -67,6 +1087,7 @@ int main(int argc, char **argv)
 
     long int tamanho = atol(argv[1]);
     const char *arquivo_vetor = argv[2];
+    const char *modo = (argc > 3) ? argv[3] : "classico";
 
     if (tamanho <= 0)
     {
@@ -74,9 +1095,26 @@ int main(int argc, char **argv)
         return 1;
     }
 
+    if (strcmp(modo, "classico") != 0 && strcmp(modo, "introsort") != 0 && strcmp(modo, "amostragem") != 0 &&
+        strcmp(modo, "intercalacao") != 0 && strcmp(modo, "radix") != 0 && strcmp(modo, "autotune") != 0)
+    {
+        fprintf(stderr, "Erro: Modo desconhecido '%s'.\n", modo);
+        return 1;
+    }
+
+    // Corte, profundidade extra e threads ajustados para este tamanho pelo
+    // modo autotune, se houver perfil
+    long int corte = ppc_profile_get("quicksort_corte", tamanho, QUICKSORT_CORTE);
+    int profundidade_extra = ppc_profile_get("quicksort_profundidade_extra", tamanho, 0);
+    if (strcmp(modo, "autotune") != 0)
+        ppc_profile_apply_threads("quicksort_threads", tamanho);
+
     printf("Quicksort (Paralelo)\n");
     printf("Tamanho do vetor: %ld\n", tamanho);
     printf("Arquivo: %s\n", arquivo_vetor);
+    printf("Modo: %s\n", modo);
+    printf("Corte para tasks: %ld, profundidade extra: %d\n", corte, profundidade_extra);
+    printf("Partição paralela acima de: %ld elementos\n", LIMITE_PARTICAO_PARALELA);
     printf("Número de threads disponíveis: %d\n", omp_get_max_threads());
     printf("\n");
 
@@ -93,6 +1131,14 @@ int main(int argc, char **argv)
         save_double_vector(vetor, tamanho, arquivo_vetor);
     }
 
+    if (strcmp(modo, "autotune") == 0)
+    {
+        printf("\n");
+        autoajustar(vetor, tamanho);
+        free(vetor);
+        return 0;
+    }
+
     printf("\nVetor original (primeiros %ld elementos):\n", tamanho < 10 ? tamanho : 10);
     print_double_vector(vetor, tamanho < 10 ? tamanho : 10, 10);
     printf("\n");
@@ -100,18 +1146,14 @@ int main(int argc, char **argv)
     // Início da medição de tempo
     double inicio = omp_get_wtime();
 
-    int max_depth = 0;
-    int num_threads = omp_get_max_threads();
-    while ((1 << max_depth) < num_threads)
-    {
-        max_depth++;
-    }
-
-    #pragma omp parallel
-    {
-        #pragma omp single
-        quicksort_parallel(vetor, 0, tamanho - 1, max_depth);
-    }
+    if (strcmp(modo, "amostragem") == 0)
+        ordenar_amostragem(vetor, tamanho);
+    else if (strcmp(modo, "intercalacao") == 0)
+        ordenar_multiplas_vias(vetor, tamanho);
+    else if (strcmp(modo, "radix") == 0)
+        ordenar_radix(vetor, tamanho);
+    else
+        ordenar_paralelo(vetor, tamanho, corte, profundidade_extra, strcmp(modo, "introsort") == 0);
 
     // Fim da medição de tempo
     double fim = omp_get_wtime();
@@ -1,10 +1,17 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <time.h>
 #include <omp.h>
 #include <libppc.h>
 
+// Subvetores até este tamanho são ordenados por inserção (modos introsort e intercalacao)
+#define LIMITE_INSERCAO 16
+
+// A partir deste tamanho o pivô é a pseudomediana de 9 (ninther), e não a mediana de 3
+#define LIMITE_NINTHER 128
+
 void trocar_elementos(double *a, double *b)
 {
     double temp = *a;
@@ -40,12 +47,224 @@ void quicksort(double *vetor, long int low, long int high)
     }
 }
 
+void ordenar_insercao(double *vetor, long int low, long int high)
+{
+    for (long int i = low + 1; i <= high; i++)
+    {
+        double valor = vetor[i];
+        long int j = i - 1;
+
+        while (j >= low && vetor[j] > valor)
+        {
+            vetor[j + 1] = vetor[j];
+            j--;
+        }
+        vetor[j + 1] = valor;
+    }
+}
+
+// Desce vetor[base + raiz] no heap de máximo vetor[base .. base + tamanho - 1]
+void descer_heap(double *vetor, long int base, long int raiz, long int tamanho)
+{
+    double valor = vetor[base + raiz];
+
+    while (2 * raiz + 1 < tamanho)
+    {
+        long int filho = 2 * raiz + 1;
+
+        if (filho + 1 < tamanho && vetor[base + filho + 1] > vetor[base + filho])
+            filho++;
+        if (vetor[base + filho] <= valor)
+            break;
+
+        vetor[base + raiz] = vetor[base + filho];
+        raiz = filho;
+    }
+    vetor[base + raiz] = valor;
+}
+
+void heapsort(double *vetor, long int low, long int high)
+{
+    long int tamanho = high - low + 1;
+
+    for (long int i = tamanho / 2 - 1; i >= 0; i--)
+        descer_heap(vetor, low, i, tamanho);
+
+    for (long int fim = tamanho - 1; fim > 0; fim--)
+    {
+        trocar_elementos(&vetor[low], &vetor[low + fim]);
+        descer_heap(vetor, low, 0, fim);
+    }
+}
+
+double mediana_de_tres(double a, double b, double c)
+{
+    if (a < b)
+        return (b < c) ? b : (a < c) ? c : a;
+    return (a < c) ? a : (b < c) ? c : b;
+}
+
+// Mediana de 3 (início, meio e fim), ou, em subvetores grandes, a mediana
+// das medianas de 3 trios espalhados (ninther de Tukey): um vetor já
+// ordenado, invertido ou em "dente de serra" não dá mais o pior pivô
+double escolher_pivo(const double *vetor, long int low, long int high)
+{
+    long int meio = low + (high - low) / 2;
+
+    if (high - low + 1 < LIMITE_NINTHER)
+        return mediana_de_tres(vetor[low], vetor[meio], vetor[high]);
+
+    long int passo = (high - low + 1) / 8;
+
+    return mediana_de_tres(
+        mediana_de_tres(vetor[low], vetor[low + passo], vetor[low + 2 * passo]),
+        mediana_de_tres(vetor[meio - passo], vetor[meio], vetor[meio + passo]),
+        mediana_de_tres(vetor[high - 2 * passo], vetor[high - passo], vetor[high]));
+}
+
+// Partição em 3 vias de Bentley e McIlroy: varre dos dois lados como a de
+// Hoare, trocando só os pares fora do lugar, e guarda os iguais ao pivô
+// nas pontas, levados para o meio no fim. Resultado: vetor[low ..
+// *menor_fim - 1] < pivô, vetor[*menor_fim .. *maior_inicio - 1] == pivô e
+// vetor[*maior_inicio .. high] > pivô. Os iguais saem da recursão, então
+// valores repetidos deixam a ordenação mais rápida, e não O(n²)
+void particao_tres_vias(double *vetor, long int low, long int high, double pivo,
+                        long int *menor_fim, long int *maior_inicio)
+{
+    long int a = low, b = low, c = high, d = high;
+
+    for (;;)
+    {
+        while (b <= c && vetor[b] <= pivo)
+        {
+            if (vetor[b] == pivo)
+                trocar_elementos(&vetor[a++], &vetor[b]);
+            b++;
+        }
+        while (c >= b && vetor[c] >= pivo)
+        {
+            if (vetor[c] == pivo)
+                trocar_elementos(&vetor[c], &vetor[d--]);
+            c--;
+        }
+        if (b > c)
+            break;
+        trocar_elementos(&vetor[b++], &vetor[c--]);
+    }
+
+    // Iguais de vetor[low .. a - 1] e vetor[d + 1 .. high] para o meio
+    long int n = (a - low < b - a) ? a - low : b - a;
+    for (long int k = 0; k < n; k++)
+        trocar_elementos(&vetor[low + k], &vetor[b - n + k]);
+
+    n = (d - c < high - d) ? d - c : high - d;
+    for (long int k = 0; k < n; k++)
+        trocar_elementos(&vetor[b + k], &vetor[high - n + 1 + k]);
+
+    *menor_fim = low + (b - a);
+    *maior_inicio = high - (d - c) + 1;
+}
+
+// Profundidade máxima da recursão do introsort, 2 log2(tamanho)
+int limite_profundidade(long int tamanho)
+{
+    int limite = 0;
+
+    while (tamanho > 1)
+    {
+        tamanho >>= 1;
+        limite += 2;
+    }
+
+    return limite;
+}
+
+// Introsort: quicksort com pivô por mediana (escolher_pivo) e partição em 3
+// vias, que vira heapsort se a recursão passar de 2 log2(n) níveis (o pior
+// caso fica O(n log n)), com inserção nos subvetores pequenos. A recursão é
+// só na parte menor, e a maior continua no laço, então a pilha tem no
+// máximo log2(n) chamadas
+void introsort(double *vetor, long int low, long int high, int profundidade)
+{
+    while (high - low + 1 > LIMITE_INSERCAO)
+    {
+        if (profundidade == 0)
+        {
+            heapsort(vetor, low, high);
+            return;
+        }
+        profundidade--;
+
+        long int menor_fim, maior_inicio;
+        particao_tres_vias(vetor, low, high, escolher_pivo(vetor, low, high), &menor_fim, &maior_inicio);
+
+        if (menor_fim - low < high - maior_inicio + 1)
+        {
+            introsort(vetor, low, menor_fim - 1, profundidade);
+            low = maior_inicio;
+        }
+        else
+        {
+            introsort(vetor, maior_inicio, high, profundidade);
+            high = menor_fim - 1;
+        }
+    }
+
+    ordenar_insercao(vetor, low, high);
+}
+
+// Intercala origem[low .. meio - 1] e origem[meio .. high - 1], já ordenados,
+// em destino[low .. high - 1]; nos empates vem primeiro o da esquerda (estável)
+void intercalar(const double *origem, double *destino, long int low, long int meio, long int high)
+{
+    long int i = low, j = meio, k = low;
+
+    while (i < meio && j < high)
+        destino[k++] = (origem[j] < origem[i]) ? origem[j++] : origem[i++];
+    while (i < meio)
+        destino[k++] = origem[i++];
+    while (j < high)
+        destino[k++] = origem[j++];
+}
+
+// Merge sort estável de vetor[low .. high], de baixo para cima: blocos de
+// LIMITE_INSERCAO elementos por inserção, e passadas de intercalação que
+// alternam entre vetor e auxiliar (nas mesmas posições), em acessos
+// sequenciais; o resultado fica em vetor
+void ordenar_intercalacao(double *vetor, double *auxiliar, long int low, long int high)
+{
+    long int fim = high + 1;
+
+    for (long int i = low; i < fim; i += LIMITE_INSERCAO)
+        ordenar_insercao(vetor, i, ((i + LIMITE_INSERCAO < fim) ? i + LIMITE_INSERCAO : fim) - 1);
+
+    double *origem = vetor, *destino = auxiliar;
+
+    for (long int largura = LIMITE_INSERCAO; largura < fim - low; largura *= 2)
+    {
+        for (long int i = low; i < fim; i += 2 * largura)
+        {
+            long int meio = (i + largura < fim) ? i + largura : fim;
+            long int final = (i + 2 * largura < fim) ? i + 2 * largura : fim;
+            intercalar(origem, destino, i, meio, final);
+        }
+
+        double *temp = origem;
+        origem = destino;
+        destino = temp;
+    }
+
+    if (origem != vetor)
+        memcpy(&vetor[low], &origem[low], sizeof(double) * (fim - low));
+}
+
 int main(int argc, char **argv)
 {
     // Valida argumentos passados via terminal
-    if (argc != 3)
+    if (argc < 3 || argc > 4)
     {
-        fprintf(stderr, "Uso: %s <tamanho> <arquivo_vetor>\n", argv[0]);
+        fprintf(stderr, "Uso: %s <tamanho> <arquivo_vetor> [modo]\n", argv[0]);
+        fprintf(stderr, "Modos: classico (padrão), introsort, intercalacao\n");
         fprintf(stderr, "Exemplo: %s 10 vetor.in\n", argv[0]);
         return 1;
     }
@@ -54,6 +273,7 @@ int main(int argc, char **argv)
 
     long int tamanho = atol(argv[1]);
     const char *arquivo_vetor = argv[2];
+    const char *modo = (argc > 3) ? argv[3] : "classico";
 
     if (tamanho <= 0)
     {
@@ -61,9 +281,16 @@ int main(int argc, char **argv)
         return 1;
     }
 
+    if (strcmp(modo, "classico") != 0 && strcmp(modo, "introsort") != 0 && strcmp(modo, "intercalacao") != 0)
+    {
+        fprintf(stderr, "Erro: Modo desconhecido '%s'.\n", modo);
+        return 1;
+    }
+
     printf("Quicksort (Serial)\n");
     printf("Tamanho do vetor: %ld\n", tamanho);
     printf("Arquivo: %s\n", arquivo_vetor);
+    printf("Modo: %s\n", modo);
     printf("\n");
 
     double *vetor;
@@ -86,7 +313,16 @@ int main(int argc, char **argv)
     // Início da medição de tempo
     double inicio = omp_get_wtime();
 
-    quicksort(vetor, 0, tamanho - 1);
+    if (strcmp(modo, "introsort") == 0)
+        introsort(vetor, 0, tamanho - 1, limite_profundidade(tamanho));
+    else if (strcmp(modo, "intercalacao") == 0)
+    {
+        double *auxiliar = (double *)malloc(sizeof(double) * tamanho);
+        ordenar_intercalacao(vetor, auxiliar, 0, tamanho - 1);
+        free(auxiliar);
+    }
+    else
+        quicksort(vetor, 0, tamanho - 1);
 
     // Fim da medição de tempo
     double fim = omp_get_wtime();
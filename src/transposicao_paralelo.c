@@ -0,0 +1,187 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <omp.h>
+#include <libppc.h>
+
+// Lado dos ladrilhos do modo ladrilhos quando o usuário não informa
+#define LADRILHO_PADRAO 64
+
+// Cópia paralela de uma matriz inteira: a banda de memória que a
+// transposição pode alcançar
+double medir_copia(const double *origem, double *destino, long int elementos)
+{
+    double inicio = omp_get_wtime();
+
+    #pragma omp parallel for schedule(static)
+    for (long int i = 0; i < elementos; i++)
+        destino[i] = origem[i];
+
+    return omp_get_wtime() - inicio;
+}
+
+void imprimir_banda(const char *operacao, double tempo, long int elementos, double banda_copia)
+{
+    // Cada elemento é lido uma vez e escrito uma vez
+    double banda = 2.0 * sizeof(double) * elementos / tempo * 1e-9;
+
+    printf("  %-28s %.6f s  %7.2f GB/s  (%.0f%% da cópia)\n", operacao, tempo, banda, 100.0 * banda / banda_copia);
+}
+
+int main(int argc, char *argv[])
+{
+    // Valida argumentos passados via terminal
+    if (argc < 3 || argc > 5)
+    {
+        fprintf(stderr, "Uso: %s <ordem> <arquivo_entrada> [modo] [ladrilho]\n", argv[0]);
+        fprintf(stderr, "Modos: fora (padrão), inplace, colunas, ladrilhos\n");
+        fprintf(stderr, "Exemplo: %s 2000 matriz.in ladrilhos 64\n", argv[0]);
+        return 1;
+    }
+
+    int ordem = atol(argv[1]);
+    char *arquivo_entrada = argv[2];
+    const char *modo = (argc > 3) ? argv[3] : "fora";
+    long int ladrilho = (argc > 4) ? atol(argv[4]) : LADRILHO_PADRAO;
+
+    if (ordem <= 0)
+    {
+        fprintf(stderr, "Erro: Ordem deve ser um número positivo!\n");
+        return 1;
+    }
+
+    if (strcmp(modo, "fora") != 0 && strcmp(modo, "inplace") != 0 && strcmp(modo, "colunas") != 0 &&
+        strcmp(modo, "ladrilhos") != 0)
+    {
+        fprintf(stderr, "Erro: Modo desconhecido '%s'.\n", modo);
+        return 1;
+    }
+
+    if (ladrilho <= 0)
+    {
+        fprintf(stderr, "Erro: O ladrilho deve ser um número positivo!\n");
+        return 1;
+    }
+
+    printf("Transposição de Matrizes (Paralelo)\n");
+    printf("Ordem da matriz: %dx%d\n", ordem, ordem);
+    printf("Matriz: %s\n", arquivo_entrada);
+    printf("Modo: %s\n", modo);
+    if (strcmp(modo, "ladrilhos") == 0)
+        printf("Ladrilho: %ldx%ld\n", ladrilho, ladrilho);
+    printf("Número de threads disponíveis: %d\n", omp_get_max_threads());
+
+    if (ppc_pin_threads())
+        printf("Afinidade: threads fixadas em CPUs (spread)\n");
+    else
+        printf("Afinidade: definida pelo runtime OpenMP (OMP_PROC_BIND/OMP_PLACES)\n");
+    printf("\n");
+
+    double *matriz;
+    if (access(arquivo_entrada, F_OK) == 0)
+    {
+        printf("Carregando matriz do arquivo...\n");
+        matriz = load_double_matrix_first_touch(arquivo_entrada, ordem, ordem, 1);
+    }
+    else
+    {
+        printf("Gerando matriz aleatória...\n");
+        matriz = generate_random_double_matrix_first_touch(ordem, ordem, 1);
+        save_double_matrix(matriz, ordem, ordem, arquivo_entrada);
+    }
+
+    if (matriz == NULL)
+    {
+        fprintf(stderr, "Erro: Não foi possível carregar a matriz.\n");
+        return 1;
+    }
+
+    if (ordem <= 10)
+    {
+        printf("\nMatriz original:\n");
+        print_double_matrix(matriz, ordem, ordem);
+        printf("\n");
+    }
+
+    long int elementos = (long int)ordem * ordem;
+
+    // Tocadas antes da medição, para não medir as faltas de página
+    double *resultado = alloc_double_matrix_first_touch(ordem, ordem, 1);
+    double *volta = alloc_double_matrix_first_touch(ordem, ordem, 1);
+
+    double banda_copia = 2.0 * sizeof(double) * elementos / medir_copia(matriz, volta, elementos) * 1e-9;
+    printf("Banda de cópia (referência): %.2f GB/s\n\n", banda_copia);
+
+    // Início da medição de tempo
+    double inicio = omp_get_wtime();
+
+    if (strcmp(modo, "inplace") == 0)
+    {
+        memcpy(resultado, matriz, sizeof(double) * elementos);
+        inicio = omp_get_wtime();
+        ppc_transpose_inplace(resultado, ordem, ordem);
+    }
+    else if (strcmp(modo, "colunas") == 0)
+        ppc_row_to_column_major(ordem, ordem, matriz, resultado);
+    else if (strcmp(modo, "ladrilhos") == 0)
+        ppc_row_major_to_tiled(ordem, ordem, ladrilho, matriz, resultado);
+    else
+        ppc_transpose(ordem, ordem, matriz, ordem, resultado, ordem);
+
+    // Fim da medição de tempo
+    double fim = omp_get_wtime();
+    double tempo_execucao = fim - inicio;
+
+    printf("Resultados:\n");
+    if (strcmp(modo, "colunas") == 0)
+        imprimir_banda("linhas -> colunas", tempo_execucao, elementos, banda_copia);
+    else if (strcmp(modo, "ladrilhos") == 0)
+        imprimir_banda("linhas -> ladrilhos", tempo_execucao, elementos, banda_copia);
+    else
+        imprimir_banda(strcmp(modo, "inplace") == 0 ? "transposição in-place" : "transposição", tempo_execucao,
+                       elementos, banda_copia);
+
+    // As conversões de layout são medidas também na volta, que precisa
+    // devolver a matriz original
+    if (strcmp(modo, "colunas") == 0 || strcmp(modo, "ladrilhos") == 0)
+    {
+        double inicio_volta = omp_get_wtime();
+
+        if (strcmp(modo, "colunas") == 0)
+            ppc_column_to_row_major(ordem, ordem, resultado, volta);
+        else
+            ppc_tiled_to_row_major(ordem, ordem, ladrilho, resultado, volta);
+
+        double tempo_volta = omp_get_wtime() - inicio_volta;
+
+        imprimir_banda(strcmp(modo, "colunas") == 0 ? "colunas -> linhas" : "ladrilhos -> linhas", tempo_volta,
+                       elementos, banda_copia);
+
+        if (compare_double_vectors(matriz, volta, elementos) != 0)
+        {
+            fprintf(stderr, "Erro: A conversão de volta não reproduz a matriz original.\n");
+            return 1;
+        }
+        printf("  Conversão de volta reproduz a matriz original\n");
+    }
+    printf("\n");
+
+    if (ordem <= 10)
+    {
+        printf("Matriz Resultado:\n");
+        print_double_matrix(resultado, ordem, ordem);
+        printf("\n");
+    }
+
+    printf("Tempo de execução (transposição): %.6f segundos\n", tempo_execucao);
+
+    save_double_matrix(resultado, ordem, ordem, "transposicao_paralelo.out");
+    printf("Matriz resultado salva em: transposicao_paralelo.out\n");
+
+    free(matriz);
+    free(resultado);
+    free(volta);
+
+    return 0;
+}
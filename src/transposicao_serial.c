@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <omp.h>
+#include <libppc.h>
+
+void transposicao(const double *matriz, double *transposta, int ordem)
+{
+    for (int i = 0; i < ordem; i++)
+    {
+        for (int j = 0; j < ordem; j++)
+        {
+            M(j, i, ordem, transposta) = M(i, j, ordem, matriz);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // Valida argumentos passados via terminal
+    if (argc < 3)
+    {
+        fprintf(stderr, "Uso: %s <ordem> <arquivo_entrada>\n", argv[0]);
+        fprintf(stderr, "Exemplo: %s 2000 matriz.in\n", argv[0]);
+        return 1;
+    }
+
+    int ordem = atol(argv[1]);
+    char *arquivo_entrada = argv[2];
+
+    if (ordem <= 0)
+    {
+        fprintf(stderr, "Erro: Ordem deve ser um número positivo!\n");
+        return 1;
+    }
+
+    printf("Transposição de Matrizes (Serial)\n");
+    printf("Ordem da matriz: %dx%d\n", ordem, ordem);
+    printf("Matriz: %s\n", arquivo_entrada);
+    printf("\n");
+
+    double *matriz;
+    if (access(arquivo_entrada, F_OK) == 0)
+    {
+        printf("Carregando matriz do arquivo...\n");
+        matriz = load_double_matrix(arquivo_entrada, ordem, ordem);
+    }
+    else
+    {
+        printf("Gerando matriz aleatória...\n");
+        matriz = generate_random_double_matrix(ordem, ordem);
+        save_double_matrix(matriz, ordem, ordem, arquivo_entrada);
+    }
+
+    if (matriz == NULL)
+    {
+        fprintf(stderr, "Erro: Não foi possível carregar a matriz.\n");
+        return 1;
+    }
+
+    if (ordem <= 10)
+    {
+        printf("\nMatriz original:\n");
+        print_double_matrix(matriz, ordem, ordem);
+        printf("\n");
+    }
+
+    // Tocada antes da medição, para não medir as faltas de página
+    double *transposta = (double *)malloc(sizeof(double) * ordem * ordem);
+    memset(transposta, 0, sizeof(double) * ordem * ordem);
+
+    // Início da medição de tempo
+    double inicio = omp_get_wtime();
+
+    transposicao(matriz, transposta, ordem);
+
+    // Fim da medição de tempo
+    double fim = omp_get_wtime();
+    double tempo_execucao = fim - inicio;
+
+    if (ordem <= 10)
+    {
+        printf("Matriz Transposta:\n");
+        print_double_matrix(transposta, ordem, ordem);
+        printf("\n");
+    }
+
+    // Cada elemento é lido uma vez e escrito uma vez
+    double bytes = 2.0 * sizeof(double) * ordem * ordem;
+
+    printf("Tempo de execução (transposição): %.6f segundos\n", tempo_execucao);
+    printf("Banda efetiva: %.2f GB/s\n", bytes / tempo_execucao * 1e-9);
+
+    save_double_matrix(transposta, ordem, ordem, "transposicao_serial.out");
+    printf("Matriz transposta salva em: transposicao_serial.out\n");
+
+    free(matriz);
+    free(transposta);
+
+    return 0;
+}
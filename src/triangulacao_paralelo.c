@@ -1,10 +1,33 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
 #include <unistd.h>
+#include <sched.h>
 #include <omp.h>
 #include <libppc.h>
 
-void eliminacao_gaussiana_paralela(double *matriz, int linhas, int colunas)
+#include "relatorio_numa.h"
+
+// Linhas restantes abaixo das quais um passo não compensa abrir a região paralela
+#define LIMITE_PARALELO 0
+
+// Leituras do indicador de pivô pronto antes de ceder a CPU (modo persistente)
+#define ESPERA_ATIVA 1000
+
+// Lado dos ladrilhos do modo lu_tarefas quando o usuário não informa
+#define LADRILHO_LU 128
+
+// Diagonais acima e abaixo da principal do modo banda quando o usuário não informa
+#define LARGURA_BANDA 8
+
+// Semente das matrizes de banda geradas
+#define SEMENTE_BANDA 17
+
+// Colunas da matriz dos modos qr e tsqr quando o usuário não informa
+#define COLUNAS_QR 32
+
+void eliminacao_gaussiana_paralela(double *matriz, int linhas, int colunas, int limite_paralelo)
 {
     int i, j, k;
     double fator;
@@ -17,7 +40,7 @@ void eliminacao_gaussiana_paralela(double *matriz, int linhas, int colunas)
             continue;
         }
 
-        #pragma omp parallel for private(j, k, fator) shared(matriz, i, linhas, colunas)
+        #pragma omp parallel for private(j, k, fator) shared(matriz, i, linhas, colunas) if (linhas - i - 1 > limite_paralelo)
         for (j = i + 1; j < linhas; j++)
         {
             fator = M(j, i, colunas, matriz) / M(i, i, colunas, matriz);
@@ -32,18 +55,1140 @@ void eliminacao_gaussiana_paralela(double *matriz, int linhas, int colunas)
     }
 }
 
+// Uma única região paralela para toda a eliminação. A linha j pertence à
+// thread j % threads durante todo o cálculo, então cada thread fica com as
+// mesmas linhas na sua cache e a carga continua equilibrada quando a
+// submatriz diminui. Em vez de uma barreira por pivô, a dona da linha i + 1
+// atualiza essa linha primeiro no passo i e avisa, pelo indicador pronta[i + 1],
+// que ela já pode ser o próximo pivô; as outras threads só esperam por esse
+// indicador. O resultado é o mesmo da eliminação serial.
+void eliminacao_gaussiana_persistente(double *matriz, int linhas, int colunas)
+{
+    int *pronta = (int *)calloc(linhas, sizeof(int));
+    pronta[0] = 1;
+
+    #pragma omp parallel
+    {
+        int id = omp_get_thread_num();
+        int threads = omp_get_num_threads();
+
+        for (int i = 0; i < linhas - 1; i++)
+        {
+            // Espera ativa curta; depois cede a CPU, para o caso de haver
+            // mais threads do que CPUs
+            int pronta_i;
+            for (int tentativas = 0;; tentativas++)
+            {
+                #pragma omp atomic read acquire
+                pronta_i = pronta[i];
+
+                if (pronta_i)
+                    break;
+                if (tentativas >= ESPERA_ATIVA)
+                    sched_yield();
+            }
+
+            // Primeira linha desta thread abaixo do pivô
+            int primeira = i + 1 + ((id - (i + 1)) % threads + threads) % threads;
+
+            if (M(i, i, colunas, matriz) == 0.0)
+            {
+                if (i % threads == id)
+                    fprintf(stderr, "Aviso: Pivô zero encontrado na linha %d\n", i);
+
+                // A linha i + 1 não muda neste passo
+                if (primeira == i + 1)
+                {
+                    #pragma omp atomic write release
+                    pronta[i + 1] = 1;
+                }
+                continue;
+            }
+
+            for (int j = primeira; j < linhas; j += threads)
+            {
+                double fator = M(j, i, colunas, matriz) / M(i, i, colunas, matriz);
+
+                M(j, i, colunas, matriz) = 0.0;
+
+                for (int k = i + 1; k < colunas; k++)
+                    M(j, k, colunas, matriz) -= fator * M(i, k, colunas, matriz);
+
+                if (j == i + 1)
+                {
+                    #pragma omp atomic write release
+                    pronta[i + 1] = 1;
+                }
+            }
+        }
+    }
+
+    free(pronta);
+}
+
+// Separa a matriz fatorada por ppc_dgetrf em L (triangular inferior com
+// diagonal unitária) e U (triangular superior)
+void separar_lu(const double *fatorada, int ordem, double *L, double *U)
+{
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < ordem; i++)
+    {
+        for (int j = 0; j < ordem; j++)
+        {
+            M(i, j, ordem, L) = (j < i) ? M(i, j, ordem, fatorada) : (j == i) ? 1.0 : 0.0;
+            M(i, j, ordem, U) = (j >= i) ? M(i, j, ordem, fatorada) : 0.0;
+        }
+    }
+}
+
+// Resíduo relativo max|PA - LU| / (ordem * max|A|), com a matriz original
+// permutada pelos pivôs (sem pivôs, NULL); da ordem do epsilon da máquina se
+// a fatoração está certa
+double residuo_lu(const double *original, const double *L, const double *U, const int *pivos, int ordem)
+{
+    double *residuo = (double *)malloc(sizeof(double) * ordem * ordem);
+    double maior_a = 0.0, maior_residuo = 0.0;
+
+    memcpy(residuo, original, sizeof(double) * ordem * ordem);
+    if (pivos != NULL)
+        ppc_dlaswp(ordem, residuo, ordem, 0, ordem, pivos);
+    ppc_dgemm(ordem, ordem, ordem, -1.0, L, ordem, U, ordem, 1.0, residuo, ordem);
+
+    #pragma omp parallel for reduction(max : maior_a, maior_residuo)
+    for (long int i = 0; i < (long int)ordem * ordem; i++)
+    {
+        if (fabs(original[i]) > maior_a)
+            maior_a = fabs(original[i]);
+        if (fabs(residuo[i]) > maior_residuo)
+            maior_residuo = fabs(residuo[i]);
+    }
+
+    free(residuo);
+
+    return (maior_a > 0.0) ? maior_residuo / (ordem * maior_a) : 0.0;
+}
+
+// Eliminação medida pelo autotune: cada medição elimina uma cópia nova da
+// matriz original, com o limite de linhas dado para paralelizar um passo
+typedef struct
+{
+    const double *original;
+    double *copia;
+    int ordem;
+    int limite_paralelo;
+} medicao_eliminacao;
+
+void restaurar_copia(void *contexto)
+{
+    medicao_eliminacao *medicao = (medicao_eliminacao *)contexto;
+
+    memcpy(medicao->copia, medicao->original, sizeof(double) * medicao->ordem * medicao->ordem);
+}
+
+void executar_medicao(void *contexto)
+{
+    medicao_eliminacao *medicao = (medicao_eliminacao *)contexto;
+
+    eliminacao_gaussiana_paralela(medicao->copia, medicao->ordem, medicao->ordem, medicao->limite_paralelo);
+}
+
+// Menor tempo de algumas eliminações de cópias da matriz original
+double medir_eliminacao(const double *original, double *copia, int ordem, int limite_paralelo)
+{
+    medicao_eliminacao medicao = {original, copia, ordem, limite_paralelo};
+
+    return ppc_profile_time(restaurar_copia, executar_medicao, &medicao);
+}
+
+// Modo autotune: escolhe o número de threads e o limite de linhas para
+// paralelizar um passo da eliminação e grava no perfil
+void autoajustar(const double *original, int ordem)
+{
+    const int opcoes_limite[] = {0, 16, 64, 256, 1024};
+    double *copia = alloc_double_matrix_first_touch(ordem, ordem, 1);
+    double tempo, melhor_tempo;
+    int limite = LIMITE_PARALELO;
+
+    // Com o limite padrão, e com as threads fixadas em CPUs como na eliminação
+    // do programa
+    printf("Autoajuste do número de threads:\n");
+    medicao_eliminacao medicao = {original, copia, ordem, LIMITE_PARALELO};
+    int threads = ppc_profile_tune_threads(restaurar_copia, executar_medicao, &medicao, 1);
+    omp_set_num_threads(threads);
+    ppc_pin_threads();
+
+    printf("\nAutoajuste do limite paralelo (%d threads):\n", threads);
+    melhor_tempo = -1.0;
+    for (unsigned i = 0; i < sizeof(opcoes_limite) / sizeof(opcoes_limite[0]); i++)
+    {
+        if (opcoes_limite[i] >= ordem && i > 0)
+            break;
+
+        tempo = medir_eliminacao(original, copia, ordem, opcoes_limite[i]);
+        printf("  limite=%d: %.6f s\n", opcoes_limite[i], tempo);
+        if (melhor_tempo < 0.0 || tempo < melhor_tempo)
+        {
+            melhor_tempo = tempo;
+            limite = opcoes_limite[i];
+        }
+    }
+
+    ppc_profile_set("triangulacao_threads", ordem, threads);
+    ppc_profile_set("triangulacao_limite_paralelo", ordem, limite);
+
+    printf("\nMelhores parâmetros para ordem %d:\n", ordem);
+    printf("  threads=%d limite paralelo=%d\n", threads, limite);
+    printf("Perfil salvo em: %s\n", ppc_profile_filename());
+
+    free(copia);
+}
+
+// Modos lu e lu_tarefas: fatoração LU com pivoteamento parcial,
+// P * A = L * U, blocada (ladrilho 0) ou em tasks por ladrilhos.
+// Grava U em saida_paralelo.out (a matriz triangular superior, como na
+// eliminação), L em L_paralelo.out e os pivôs em pivos_paralelo.out
+int executar_lu(double *matriz, int ordem, long int ladrilho)
+{
+    double *original = (double *)malloc(sizeof(double) * ordem * ordem);
+    int *pivos = (int *)malloc(sizeof(int) * ordem);
+
+    memcpy(original, matriz, sizeof(double) * ordem * ordem);
+
+    // Início da medição de tempo
+    double inicio = omp_get_wtime();
+
+    int info;
+    if (ladrilho > 0)
+        info = ppc_dgetrf_tiled(ordem, ordem, matriz, ordem, pivos, ladrilho);
+    else
+        info = ppc_dgetrf(ordem, ordem, matriz, ordem, pivos);
+
+    // Fim da medição de tempo
+    double fim = omp_get_wtime();
+    double tempo_execucao = fim - inicio;
+
+    if (info != 0)
+        fprintf(stderr, "Aviso: Matriz singular, pivô zero na coluna %d\n", info - 1);
+
+    double *L = alloc_double_matrix_first_touch(ordem, ordem, 1);
+    double *U = alloc_double_matrix_first_touch(ordem, ordem, 1);
+    separar_lu(matriz, ordem, L, U);
+
+    if (ordem <= 10)
+    {
+        printf("Matriz L:\n");
+        print_double_matrix(L, ordem, ordem);
+        printf("\nMatriz U:\n");
+        print_double_matrix(U, ordem, ordem);
+        printf("\nPivôs (linha i trocada com a linha pivos[i]):\n");
+        for (int i = 0; i < ordem; i++)
+            printf("%d%s", pivos[i], (i < ordem - 1) ? " " : "\n");
+        printf("\n");
+    }
+
+    double gflops = 2.0 / 3.0 * ordem * ordem * (double)ordem / tempo_execucao * 1e-9;
+
+    printf("Tempo de execução (fatoração LU): %.6f segundos\n", tempo_execucao);
+    printf("Desempenho: %.2f GFLOP/s\n", gflops);
+    printf("Resíduo relativo max|PA - LU| / (n max|A|): %.3e\n", residuo_lu(original, L, U, pivos, ordem));
+
+    printf("Páginas por nó NUMA:\n");
+    imprimir_distribuicao_numa("Matriz", matriz, (long int)ordem * ordem);
+
+    save_double_matrix(U, ordem, ordem, "saida_paralelo.out");
+    save_double_matrix(L, ordem, ordem, "L_paralelo.out");
+    save_int_vector(pivos, ordem, "pivos_paralelo.out");
+    printf("Matriz U salva em: saida_paralelo.out\n");
+    printf("Matriz L salva em: L_paralelo.out\n");
+    printf("Pivôs salvos em: pivos_paralelo.out\n");
+
+    free(original);
+    free(pivos);
+    free(L);
+    free(U);
+
+    return 0;
+}
+
+// Candidato a pivô da redução paralela: o maior |a| da coluna e a sua
+// posição lógica; no empate fica a menor posição, como na busca serial
+typedef struct
+{
+    double valor;
+    int posicao;
+} candidato_pivo;
+
+#pragma omp declare reduction(maior_pivo : candidato_pivo : \
+    omp_out = (omp_in.valor > omp_out.valor || (omp_in.valor == omp_out.valor && omp_in.posicao < omp_out.posicao)) ? omp_in : omp_out) \
+    initializer(omp_priv = (candidato_pivo){-1.0, -1})
+
+// Eliminação com pivoteamento parcial sem mover linhas: a linha lógica i é a
+// linha física linha[i], e trocar duas linhas é trocar dois índices. A busca
+// do pivô da coluna k + 1 é uma redução paralela feita no mesmo laço que
+// atualiza as linhas no passo k, que já calcula os novos valores da coluna.
+// Os multiplicadores ficam abaixo da diagonal (fatoração LU de PA), e
+// pivos[k] recebe a posição trocada com k, como em ppc_dgetrf.
+// Retorna 0, ou k + 1 se a coluna k não tem pivô diferente de zero
+int eliminacao_gaussiana_pivotada(double *matriz, int ordem, int *linha, int *pivos, int limite_paralelo)
+{
+    int info = 0;
+    candidato_pivo pivo = {-1.0, -1};
+
+    for (int i = 0; i < ordem; i++)
+    {
+        linha[i] = i;
+        if (fabs(M(i, 0, ordem, matriz)) > pivo.valor)
+            pivo = (candidato_pivo){fabs(M(i, 0, ordem, matriz)), i};
+    }
+
+    for (int k = 0; k < ordem; k++)
+    {
+        int trocada = linha[k];
+
+        pivos[k] = pivo.posicao;
+        linha[k] = linha[pivo.posicao];
+        linha[pivo.posicao] = trocada;
+
+        double *linha_pivo = &M(linha[k], 0, ordem, matriz);
+        int zero = linha_pivo[k] == 0.0;
+
+        if (zero && info == 0)
+            info = k + 1;
+
+        candidato_pivo proximo = {-1.0, -1};
+
+        #pragma omp parallel for reduction(maior_pivo : proximo) if (ordem - k - 1 > limite_paralelo)
+        for (int i = k + 1; i < ordem; i++)
+        {
+            double *atual = &M(linha[i], 0, ordem, matriz);
+
+            if (!zero)
+            {
+                double fator = atual[k] / linha_pivo[k];
+
+                atual[k] = fator;
+                for (int j = k + 1; j < ordem; j++)
+                    atual[j] -= fator * linha_pivo[j];
+            }
+
+            if (fabs(atual[k + 1]) > proximo.valor)
+                proximo = (candidato_pivo){fabs(atual[k + 1]), i};
+        }
+
+        pivo = proximo;
+    }
+
+    return info;
+}
+
+// Materializa a permutação: a linha i de destino recebe a linha física
+// linha[i] de matriz. Só é chamada no fim, ou quando a matriz permutada é
+// pedida; durante a eliminação nenhuma linha é copiada
+void materializar_linhas(const double *matriz, const int *linha, int ordem, double *destino)
+{
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < ordem; i++)
+        memcpy(&M(i, 0, ordem, destino), &M(linha[i], 0, ordem, matriz), sizeof(double) * ordem);
+}
+
+// Fator de crescimento max|U| / max|A| (o mesmo do dgesvx do LAPACK, pela
+// matriz final): perto de 1 a eliminação é estável, e grande indica que
+// os erros de arredondamento foram amplificados
+double fator_crescimento(const double *original, const double *U, int ordem)
+{
+    double maior_a = 0.0, maior_u = 0.0;
+
+    #pragma omp parallel for reduction(max : maior_a, maior_u)
+    for (long int i = 0; i < (long int)ordem * ordem; i++)
+    {
+        if (fabs(original[i]) > maior_a)
+            maior_a = fabs(original[i]);
+        if (i % ordem >= i / ordem && fabs(U[i]) > maior_u)
+            maior_u = fabs(U[i]);
+    }
+
+    return (maior_a > 0.0) ? maior_u / maior_a : 0.0;
+}
+
+// Modo pivotado: eliminação com pivoteamento parcial por índice de linhas.
+// Para comparar a estabilidade, elimina também uma cópia sem pivoteamento
+// (modo classico) e mostra os dois fatores de crescimento
+int executar_pivotado(double *matriz, int ordem, int limite_paralelo)
+{
+    double *original = (double *)malloc(sizeof(double) * ordem * ordem);
+    int *linha = (int *)malloc(sizeof(int) * ordem);
+    int *pivos = (int *)malloc(sizeof(int) * ordem);
+
+    memcpy(original, matriz, sizeof(double) * ordem * ordem);
+
+    // Início da medição de tempo
+    double inicio = omp_get_wtime();
+
+    int info = eliminacao_gaussiana_pivotada(matriz, ordem, linha, pivos, limite_paralelo);
+
+    // Fim da medição de tempo
+    double tempo_execucao = omp_get_wtime() - inicio;
+
+    if (info != 0)
+        fprintf(stderr, "Aviso: Matriz singular, pivô zero na coluna %d\n", info - 1);
+
+    double *permutada = alloc_double_matrix_first_touch(ordem, ordem, 1);
+    double *L = alloc_double_matrix_first_touch(ordem, ordem, 1);
+    double *U = alloc_double_matrix_first_touch(ordem, ordem, 1);
+
+    inicio = omp_get_wtime();
+    materializar_linhas(matriz, linha, ordem, permutada);
+    double tempo_permutacao = omp_get_wtime() - inicio;
+
+    separar_lu(permutada, ordem, L, U);
+
+    // Referência sem pivoteamento, sobre a matriz original
+    memcpy(permutada, original, sizeof(double) * ordem * ordem);
+    inicio = omp_get_wtime();
+    eliminacao_gaussiana_paralela(permutada, ordem, ordem, limite_paralelo);
+    double tempo_classico = omp_get_wtime() - inicio;
+
+    if (ordem <= 10)
+    {
+        printf("Matriz U:\n");
+        print_double_matrix(U, ordem, ordem);
+        printf("\nLinhas (a linha i de U veio da linha linha[i] de A):\n");
+        for (int i = 0; i < ordem; i++)
+            printf("%d%s", linha[i], (i < ordem - 1) ? " " : "\n");
+        printf("\n");
+    }
+
+    printf("Tempo de execução (eliminação com pivoteamento): %.6f segundos\n", tempo_execucao);
+    printf("Materialização da permutação: %.6f segundos\n", tempo_permutacao);
+    printf("Eliminação sem pivoteamento (classico): %.6f segundos\n", tempo_classico);
+    printf("Fator de crescimento max|U| / max|A|:\n");
+    printf("  Com pivoteamento: %.3e\n", fator_crescimento(original, U, ordem));
+    printf("  Sem pivoteamento: %.3e\n", fator_crescimento(original, permutada, ordem));
+    printf("Resíduo relativo max|PA - LU| / (n max|A|): %.3e\n", residuo_lu(original, L, U, pivos, ordem));
+
+    save_double_matrix(U, ordem, ordem, "saida_paralelo.out");
+    save_double_matrix(L, ordem, ordem, "L_paralelo.out");
+    save_int_vector(pivos, ordem, "pivos_paralelo.out");
+    printf("Matriz U salva em: saida_paralelo.out\n");
+    printf("Matriz L salva em: L_paralelo.out\n");
+    printf("Pivôs salvos em: pivos_paralelo.out\n");
+
+    free(original);
+    free(linha);
+    free(pivos);
+    free(permutada);
+    free(L);
+    free(U);
+
+    return 0;
+}
+
+// Modo inversa: determinante, log-determinante, estimativa do número de
+// condição e inversa pela API da LibPPC, que fatora a matriz uma vez e
+// guarda a fatoração em cache: só a primeira chamada paga a fatoração.
+// Grava a inversa em inversa_paralelo.out
+int executar_inversa(double *matriz, int ordem)
+{
+    double *inversa = alloc_double_matrix_first_touch(ordem, ordem, 1);
+    long int acertos, falhas;
+    int sinal;
+
+    double inicio = omp_get_wtime();
+    double log_determinante = ppc_log_determinant(ordem, matriz, ordem, &sinal);
+    double tempo_log = omp_get_wtime() - inicio;
+
+    inicio = omp_get_wtime();
+    double determinante = ppc_determinant(ordem, matriz, ordem);
+    double tempo_determinante = omp_get_wtime() - inicio;
+
+    inicio = omp_get_wtime();
+    double condicao = ppc_condition_estimate(ordem, matriz, ordem);
+    double tempo_condicao = omp_get_wtime() - inicio;
+
+    inicio = omp_get_wtime();
+    int info = ppc_inverse(ordem, matriz, ordem, inversa, ordem);
+    double tempo_inversa = omp_get_wtime() - inicio;
+
+    ppc_lu_cache_stats(&acertos, &falhas);
+
+    if (info > 0)
+    {
+        fprintf(stderr, "Erro: Matriz singular, pivô zero na coluna %d; não tem inversa.\n", info - 1);
+        free(inversa);
+        return 1;
+    }
+
+    if (ordem <= 10)
+    {
+        printf("Matriz inversa:\n");
+        print_double_matrix(inversa, ordem, ordem);
+        printf("\n");
+    }
+
+    // max|A A^-1 - I|
+    double *produto = alloc_double_matrix_first_touch(ordem, ordem, 1);
+    double erro = 0.0;
+
+    ppc_dgemm(ordem, ordem, ordem, 1.0, matriz, ordem, inversa, ordem, 0.0, produto, ordem);
+
+    #pragma omp parallel for reduction(max : erro)
+    for (long int i = 0; i < (long int)ordem * ordem; i++)
+        erro = fmax(erro, fabs(produto[i] - ((i / ordem == i % ordem) ? 1.0 : 0.0)));
+
+    printf("Log-determinante: %.6f (sinal %+d)\n", log_determinante, sinal);
+    printf("Determinante: %.6e\n", determinante);
+    printf("Número de condição estimado (norma 1): %.3e\n", condicao);
+    printf("Erro max|A A^-1 - I|: %.3e\n", erro);
+    printf("\nTempos (a fatoração LU é feita na primeira chamada e reutilizada):\n");
+    printf("  Log-determinante (fatoração): %.6f segundos\n", tempo_log);
+    printf("  Determinante: %.6f segundos\n", tempo_determinante);
+    printf("  Estimativa da condição: %.6f segundos\n", tempo_condicao);
+    printf("  Inversa: %.6f segundos\n", tempo_inversa);
+    printf("Cache de fatorações: %ld acertos, %ld falhas\n", acertos, falhas);
+    printf("Tempo de execução (total): %.6f segundos\n", tempo_log + tempo_determinante + tempo_condicao + tempo_inversa);
+
+    save_double_matrix(inversa, ordem, ordem, "inversa_paralelo.out");
+    printf("Matriz inversa salva em: inversa_paralelo.out\n");
+
+    ppc_lu_cache_clear();
+    free(produto);
+    free(inversa);
+
+    return 0;
+}
+
+// Testa se a matriz é exatamente simétrica
+int simetrica(const double *matriz, int ordem)
+{
+    int resultado = 1;
+
+    #pragma omp parallel for reduction(&& : resultado) schedule(dynamic, 16)
+    for (int i = 0; i < ordem; i++)
+        for (int j = 0; j < i; j++)
+            resultado = resultado && M(i, j, ordem, matriz) == M(j, i, ordem, matriz);
+
+    return resultado;
+}
+
+// Modo cholesky: A = L * L^T para matrizes simétricas positivas definidas,
+// usando só o triângulo inferior. Se a matriz não é simétrica, ou não é
+// positiva definida (um pivô da fatoração não é positivo), faz a fatoração
+// LU com pivoteamento. Grava U = L^T em saida_paralelo.out e L em L_paralelo.out
+int executar_cholesky(double *matriz, int ordem)
+{
+    if (!simetrica(matriz, ordem))
+    {
+        printf("A matriz não é simétrica: usando a fatoração LU.\n\n");
+        return executar_lu(matriz, ordem, 0);
+    }
+
+    double *original = (double *)malloc(sizeof(double) * ordem * ordem);
+    memcpy(original, matriz, sizeof(double) * ordem * ordem);
+
+    // Início da medição de tempo
+    double inicio = omp_get_wtime();
+
+    int info = ppc_dpotrf(ordem, matriz, ordem);
+
+    // Fim da medição de tempo
+    double fim = omp_get_wtime();
+    double tempo_execucao = fim - inicio;
+
+    if (info != 0)
+    {
+        printf("A matriz não é positiva definida (menor principal de ordem %d): usando a fatoração LU.\n", info);
+        printf("Tempo da tentativa de Cholesky: %.6f segundos\n\n", tempo_execucao);
+        memcpy(matriz, original, sizeof(double) * ordem * ordem);
+        free(original);
+        return executar_lu(matriz, ordem, 0);
+    }
+
+    // L é o triângulo inferior do resultado; U = L^T
+    double *L = alloc_double_matrix_first_touch(ordem, ordem, 1);
+    double *U = alloc_double_matrix_first_touch(ordem, ordem, 1);
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < ordem; i++)
+        for (int j = 0; j <= i; j++)
+            M(i, j, ordem, L) = M(i, j, ordem, matriz);
+    ppc_transpose(ordem, ordem, L, ordem, U, ordem);
+
+    if (ordem <= 10)
+    {
+        printf("Matriz L:\n");
+        print_double_matrix(L, ordem, ordem);
+        printf("\n");
+    }
+
+    double gflops = 1.0 / 3.0 * ordem * ordem * (double)ordem / tempo_execucao * 1e-9;
+
+    printf("Tempo de execução (fatoração de Cholesky): %.6f segundos\n", tempo_execucao);
+    printf("Desempenho: %.2f GFLOP/s\n", gflops);
+    printf("Resíduo relativo max|A - LL^T| / (n max|A|): %.3e\n", residuo_lu(original, L, U, NULL, ordem));
+
+    save_double_matrix(U, ordem, ordem, "saida_paralelo.out");
+    save_double_matrix(L, ordem, ordem, "L_paralelo.out");
+    printf("Matriz U = L^T salva em: saida_paralelo.out\n");
+    printf("Matriz L salva em: L_paralelo.out\n");
+
+    free(original);
+    free(L);
+    free(U);
+
+    return 0;
+}
+
+// Erro retroativo normwise das soluções: o maior, entre as colunas j, de
+// ||A x_j - b_j|| / (||A|| ||x_j|| + ||b_j||), em norma infinito. Da ordem
+// do epsilon da máquina para um método estável
+double erro_retroativo(const double *A, const double *x, const double *b, int ordem, long int colunas_b)
+{
+    double *residuo = (double *)malloc(sizeof(double) * ordem * colunas_b);
+    double norma_a = 0.0, erro = 0.0;
+
+    memcpy(residuo, b, sizeof(double) * ordem * colunas_b);
+    ppc_dgemm(ordem, colunas_b, ordem, 1.0, A, ordem, x, colunas_b, -1.0, residuo, colunas_b);
+
+    #pragma omp parallel for reduction(max : norma_a)
+    for (int i = 0; i < ordem; i++)
+    {
+        double soma = 0.0;
+        for (int j = 0; j < ordem; j++)
+            soma += fabs(M(i, j, ordem, A));
+        if (soma > norma_a)
+            norma_a = soma;
+    }
+
+    for (long int j = 0; j < colunas_b; j++)
+    {
+        double norma_r = 0.0, norma_x = 0.0, norma_b = 0.0;
+
+        for (int i = 0; i < ordem; i++)
+        {
+            norma_r = fmax(norma_r, fabs(M(i, j, colunas_b, residuo)));
+            norma_x = fmax(norma_x, fabs(M(i, j, colunas_b, x)));
+            norma_b = fmax(norma_b, fabs(M(i, j, colunas_b, b)));
+        }
+
+        if (norma_a * norma_x + norma_b > 0.0)
+            erro = fmax(erro, norma_r / (norma_a * norma_x + norma_b));
+    }
+
+    free(residuo);
+
+    return erro;
+}
+
+// Carrega os lados direitos (ordem x colunas_b, um por coluna; com uma coluna
+// é um vetor da LibPPC) ou gera e salva valores aleatórios se o arquivo não existe
+double *carregar_lados_direitos(const char *arquivo_b, int ordem, long int colunas_b)
+{
+    double *b;
+
+    if (access(arquivo_b, F_OK) == 0)
+    {
+        printf("Carregando lados direitos do arquivo %s...\n", arquivo_b);
+        b = load_double_matrix(arquivo_b, ordem, colunas_b);
+    }
+    else
+    {
+        printf("Gerando lados direitos aleatórios em %s...\n", arquivo_b);
+        b = generate_random_double_matrix(ordem, colunas_b);
+        save_double_matrix(b, ordem, colunas_b, arquivo_b);
+    }
+
+    return b;
+}
+
+// Modo resolver: A X = B para colunas_b lados direitos. Fatora uma vez
+// (ppc_dgetrf) e resolve todos juntos com as substituições blocadas
+// (ppc_dgetrs); grava X em solucao_paralelo.out
+int executar_resolver(double *matriz, int ordem, const char *arquivo_b, long int colunas_b)
+{
+    double *b = carregar_lados_direitos(arquivo_b, ordem, colunas_b);
+
+    if (b == NULL)
+    {
+        fprintf(stderr, "Erro: Não foi possível carregar os lados direitos.\n");
+        return 1;
+    }
+
+    double *original = (double *)malloc(sizeof(double) * ordem * ordem);
+    double *x = (double *)malloc(sizeof(double) * ordem * colunas_b);
+    int *pivos = (int *)malloc(sizeof(int) * ordem);
+
+    memcpy(original, matriz, sizeof(double) * ordem * ordem);
+    memcpy(x, b, sizeof(double) * ordem * colunas_b);
+
+    double inicio = omp_get_wtime();
+
+    int info = ppc_dgetrf(ordem, ordem, matriz, ordem, pivos);
+
+    double tempo_fatoracao = omp_get_wtime() - inicio;
+
+    if (info != 0)
+    {
+        fprintf(stderr, "Erro: Matriz singular, pivô zero na coluna %d; o sistema não tem solução única.\n", info - 1);
+        free(b);
+        free(original);
+        free(x);
+        free(pivos);
+        return 1;
+    }
+
+    inicio = omp_get_wtime();
+
+    ppc_dgetrs(ordem, colunas_b, matriz, ordem, pivos, x, colunas_b);
+
+    double tempo_substituicoes = omp_get_wtime() - inicio;
+
+    if (ordem <= 10)
+    {
+        printf("\nSolução X:\n");
+        print_double_matrix(x, ordem, colunas_b);
+        printf("\n");
+    }
+
+    printf("\nLados direitos: %ld\n", colunas_b);
+    printf("Tempo de execução (fatoração LU): %.6f segundos\n", tempo_fatoracao);
+    printf("Tempo de execução (substituições): %.6f segundos (%.2f GFLOP/s)\n", tempo_substituicoes,
+           2.0 * ordem * (double)ordem * colunas_b / tempo_substituicoes * 1e-9);
+    printf("Tempo de execução (total): %.6f segundos\n", tempo_fatoracao + tempo_substituicoes);
+    printf("Erro retroativo max ||Ax - b|| / (||A|| ||x|| + ||b||): %.3e\n",
+           erro_retroativo(original, x, b, ordem, colunas_b));
+
+    save_double_matrix(x, ordem, colunas_b, "solucao_paralelo.out");
+    printf("Solução salva em: solucao_paralelo.out\n");
+
+    free(b);
+    free(original);
+    free(x);
+    free(pivos);
+
+    return 0;
+}
+
+// Modo resolver_misto: A X = B com a fatoração LU em float e refinamento
+// iterativo em double (ppc_dsgesv). Para comparar, resolve também todo em
+// double; grava a solução do modo misto em solucao_paralelo.out
+int executar_resolver_misto(double *matriz, int ordem, const char *arquivo_b, long int colunas_b)
+{
+    double *b = carregar_lados_direitos(arquivo_b, ordem, colunas_b);
+
+    if (b == NULL)
+    {
+        fprintf(stderr, "Erro: Não foi possível carregar os lados direitos.\n");
+        return 1;
+    }
+
+    double *lu = (double *)malloc(sizeof(double) * ordem * ordem);
+    double *x_double = (double *)malloc(sizeof(double) * ordem * colunas_b);
+    double *x = (double *)malloc(sizeof(double) * ordem * colunas_b);
+    int *pivos = (int *)malloc(sizeof(int) * ordem);
+
+    // Referência: fatoração e substituições em double
+    memcpy(lu, matriz, sizeof(double) * ordem * ordem);
+    memcpy(x_double, b, sizeof(double) * ordem * colunas_b);
+
+    double inicio = omp_get_wtime();
+
+    int info = ppc_dgetrf(ordem, ordem, lu, ordem, pivos);
+    if (info == 0)
+        ppc_dgetrs(ordem, colunas_b, lu, ordem, pivos, x_double, colunas_b);
+
+    double tempo_double = omp_get_wtime() - inicio;
+
+    if (info != 0)
+    {
+        fprintf(stderr, "Erro: Matriz singular, pivô zero na coluna %d; o sistema não tem solução única.\n", info - 1);
+        free(b);
+        free(lu);
+        free(x_double);
+        free(x);
+        free(pivos);
+        return 1;
+    }
+
+    // Início da medição de tempo
+    inicio = omp_get_wtime();
+
+    int iteracoes;
+    ppc_dsgesv(ordem, colunas_b, matriz, ordem, b, colunas_b, x, colunas_b, &iteracoes);
+
+    // Fim da medição de tempo
+    double tempo_misto = omp_get_wtime() - inicio;
+
+    if (ordem <= 10)
+    {
+        printf("\nSolução X:\n");
+        print_double_matrix(x, ordem, colunas_b);
+        printf("\n");
+    }
+
+    printf("\nLados direitos: %ld\n", colunas_b);
+    printf("Solução em double (fatoração LU e substituições):\n");
+    printf("  Tempo: %.6f segundos\n", tempo_double);
+    printf("  Erro retroativo: %.3e\n", erro_retroativo(matriz, x_double, b, ordem, colunas_b));
+    printf("Precisão mista (fatoração LU em float, refinamento em double):\n");
+    printf("  Tempo: %.6f segundos (%.2fx)\n", tempo_misto, tempo_double / tempo_misto);
+    if (iteracoes >= 0)
+        printf("  Iterações de refinamento: %d\n", iteracoes);
+    else
+        printf("  O refinamento não convergiu: resolvido em double\n");
+    printf("  Erro retroativo: %.3e\n", erro_retroativo(matriz, x, b, ordem, colunas_b));
+    printf("Tempo de execução (precisão mista): %.6f segundos\n", tempo_misto);
+
+    save_double_matrix(x, ordem, colunas_b, "solucao_paralelo.out");
+    printf("Solução salva em: solucao_paralelo.out\n");
+
+    free(b);
+    free(lu);
+    free(x_double);
+    free(x);
+    free(pivos);
+
+    return 0;
+}
+
+// Qualidade de uma solução de mínimos quadrados: ||r||_2, com r = A x - b,
+// e ||A^T r||_2 / (||A||_F ||r||_2), que as equações normais A^T r = 0
+// levam à ordem do epsilon da máquina
+double erro_minimos_quadrados(const double *A, const double *x, const double *b, int linhas, int colunas,
+                              double *norma_residuo)
+{
+    double *gradiente = (double *)calloc(colunas, sizeof(double));
+    double soma_r = 0.0, soma_a = 0.0;
+
+    #pragma omp parallel for reduction(+ : soma_r, soma_a, gradiente[:colunas])
+    for (int i = 0; i < linhas; i++)
+    {
+        double r = -b[i];
+        for (int j = 0; j < colunas; j++)
+        {
+            r += M(i, j, colunas, A) * x[j];
+            soma_a += M(i, j, colunas, A) * M(i, j, colunas, A);
+        }
+        for (int j = 0; j < colunas; j++)
+            gradiente[j] += M(i, j, colunas, A) * r;
+        soma_r += r * r;
+    }
+
+    double soma_g = 0.0;
+    for (int j = 0; j < colunas; j++)
+        soma_g += gradiente[j] * gradiente[j];
+
+    free(gradiente);
+
+    *norma_residuo = sqrt(soma_r);
+
+    return (soma_r > 0.0) ? sqrt(soma_g) / (sqrt(soma_a) * sqrt(soma_r)) : 0.0;
+}
+
+// Modos qr e tsqr: mínimos quadrados min ||A x - b||, A com ordem linhas
+// e colunas colunas (arquivo_entrada, gerada se não existir). O modo qr usa
+// a fatoração QR blocada (ppc_dgels); o tsqr calcula só o R de [A b] por
+// TSQR, e x sai de R x = Q^T b, a última coluna de R. Grava x em
+// solucao_paralelo.out
+int executar_minimos_quadrados(const char *arquivo_entrada, int ordem, int colunas, const char *arquivo_b, int tsqr)
+{
+    double *A;
+
+    if (access(arquivo_entrada, F_OK) == 0)
+    {
+        printf("Carregando matriz do arquivo...\n");
+        A = load_double_matrix_first_touch(arquivo_entrada, ordem, colunas, 1);
+    }
+    else
+    {
+        printf("Gerando matriz aleatória...\n");
+        A = generate_random_double_matrix_first_touch(ordem, colunas, 1);
+        save_double_matrix(A, ordem, colunas, arquivo_entrada);
+    }
+
+    double *b = carregar_lados_direitos(arquivo_b, ordem, 1);
+
+    if (A == NULL || b == NULL)
+    {
+        fprintf(stderr, "Erro: Não foi possível carregar a matriz ou o lado direito.\n");
+        free(A);
+        free(b);
+        return 1;
+    }
+
+    double *fatorada = alloc_double_matrix_first_touch(ordem, colunas, 1);
+    double *x_qr = (double *)malloc(sizeof(double) * ordem);
+    double operacoes = 2.0 * ordem * colunas * (double)colunas - 2.0 / 3.0 * colunas * colunas * (double)colunas;
+
+    // QR blocada de A, aplicada a b
+    memcpy(fatorada, A, sizeof(double) * ordem * colunas);
+    memcpy(x_qr, b, sizeof(double) * ordem);
+
+    double inicio = omp_get_wtime();
+    int info = ppc_dgels(ordem, colunas, 1, fatorada, colunas, x_qr, 1);
+    double tempo_qr = omp_get_wtime() - inicio;
+
+    free(fatorada);
+
+    if (info != 0)
+    {
+        fprintf(stderr, "Erro: A não tem posto completo (R[%d][%d] é zero).\n", info - 1, info - 1);
+        free(A);
+        free(b);
+        free(x_qr);
+        return 1;
+    }
+
+    double *x = x_qr;
+    double tempo_execucao = tempo_qr;
+    double norma_residuo;
+
+    if (tsqr)
+    {
+        // [A b]: a última coluna de R é Q^T b, e o seu último elemento,
+        // a norma do resíduo
+        int largura = colunas + 1;
+        double *aumentada = alloc_double_matrix_first_touch(ordem, largura, 1);
+        double *R = (double *)malloc(sizeof(double) * largura * largura);
+
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < ordem; i++)
+        {
+            memcpy(&M(i, 0, largura, aumentada), &M(i, 0, colunas, A), sizeof(double) * colunas);
+            M(i, colunas, largura, aumentada) = b[i];
+        }
+
+        inicio = omp_get_wtime();
+
+        if (ppc_dtsqr(ordem, largura, aumentada, largura, R, largura) != 0)
+        {
+            fprintf(stderr, "Erro: O TSQR falhou (são necessárias mais linhas que colunas, e memória).\n");
+            free(aumentada);
+            free(R);
+            free(A);
+            free(b);
+            free(x_qr);
+            return 1;
+        }
+
+        x = (double *)malloc(sizeof(double) * colunas);
+        for (int i = colunas - 1; i >= 0; i--)
+        {
+            double soma = M(i, colunas, largura, R);
+            for (int j = i + 1; j < colunas; j++)
+                soma -= M(i, j, largura, R) * x[j];
+            x[i] = soma / M(i, i, largura, R);
+        }
+
+        tempo_execucao = omp_get_wtime() - inicio;
+
+        double diferenca = 0.0;
+        for (int i = 0; i < colunas; i++)
+            diferenca = fmax(diferenca, fabs(x[i] - x_qr[i]));
+
+        printf("\nQR blocada (ppc_dgels): %.6f segundos (%.2f GFLOP/s)\n", tempo_qr, operacoes / tempo_qr * 1e-9);
+        printf("TSQR: %.6f segundos (%.2f GFLOP/s, %.2fx)\n", tempo_execucao,
+               operacoes / tempo_execucao * 1e-9, tempo_qr / tempo_execucao);
+        printf("Diferença máxima entre as soluções: %.3e\n", diferenca);
+        printf("Norma do resíduo pelo R de [A b]: %.6e\n", fabs(M(colunas, colunas, largura, R)));
+
+        free(aumentada);
+        free(R);
+    }
+
+    double erro = erro_minimos_quadrados(A, x, b, ordem, colunas, &norma_residuo);
+
+    printf("\nSolução x (primeiros elementos):");
+    print_double_vector(x, colunas < 10 ? colunas : 10, 10);
+
+    printf("\nNorma do resíduo ||Ax - b||: %.6e\n", norma_residuo);
+    printf("Equações normais ||A^T r|| / (||A|| ||r||): %.3e\n", erro);
+    printf("Tempo de execução (%s): %.6f segundos\n", tsqr ? "TSQR" : "QR blocada", tempo_execucao);
+    if (!tsqr)
+        printf("Desempenho: %.2f GFLOP/s\n", operacoes / tempo_execucao * 1e-9);
+
+    save_double_vector(x, colunas, "solucao_paralelo.out");
+    printf("Solução salva em: solucao_paralelo.out\n");
+
+    if (x != x_qr)
+        free(x);
+    free(x_qr);
+    free(A);
+    free(b);
+
+    return 0;
+}
+
+// Modos banda e tridiagonal: sistemas de banda com milhões de incógnitas,
+// guardando só as diagonais (arquivo_entrada é uma matriz de banda, gerada
+// diagonal dominante se não existir). O lado direito é A * 1, então a
+// solução exata é o vetor de uns; grava x em solucao_paralelo.out
+int executar_banda(const char *arquivo_entrada, int ordem, long int largura, int tridiagonal)
+{
+    ppc_band_t *banda;
+
+    if (tridiagonal)
+        largura = 1;
+
+    if (access(arquivo_entrada, F_OK) == 0)
+    {
+        printf("Carregando matriz de banda do arquivo...\n");
+        banda = load_band_matrix(arquivo_entrada);
+        if (banda != NULL && (banda->order != ordem || (tridiagonal && (banda->kl != 1 || banda->ku != 1))))
+        {
+            fprintf(stderr, "Erro: %s tem ordem %ld e banda %ld/%ld, diferente da pedida.\n",
+                    arquivo_entrada, banda->order, banda->kl, banda->ku);
+            free_band_matrix(banda);
+            return 1;
+        }
+    }
+    else
+    {
+        printf("Gerando matriz de banda aleatória (diagonal dominante)...\n");
+        banda = generate_random_band_matrix(ordem, largura, largura, SEMENTE_BANDA);
+        if (banda != NULL)
+            save_band_matrix(banda, arquivo_entrada);
+    }
+
+    if (banda == NULL)
+    {
+        fprintf(stderr, "Erro: Não foi possível carregar a matriz de banda.\n");
+        return 1;
+    }
+
+    long int n = banda->order;
+    double *uns = (double *)malloc(sizeof(double) * n);
+    double *x = (double *)malloc(sizeof(double) * n);
+
+    for (long int i = 0; i < n; i++)
+        uns[i] = 1.0;
+    ppc_band_gbmv(banda, uns, x);
+
+    printf("Diagonais: %ld abaixo, %ld acima da principal\n", banda->kl, banda->ku);
+    printf("Memória da banda: %.2f MB (densa: %.2f MB)\n",
+           sizeof(double) * n * banda->ld / 1048576.0, sizeof(double) * (double)n * n / 1048576.0);
+
+    int info;
+    double inicio, tempo_execucao;
+
+    if (tridiagonal)
+    {
+        double *sub = (double *)malloc(sizeof(double) * n);
+        double *diagonal = (double *)malloc(sizeof(double) * n);
+        double *super = (double *)malloc(sizeof(double) * n);
+        double *x_serial = (double *)malloc(sizeof(double) * n);
+        int *pivos = (int *)malloc(sizeof(int) * n);
+
+        for (long int i = 0; i < n; i++)
+        {
+            sub[i] = (i > 0) ? BAND(banda, i, i - 1) : 0.0;
+            diagonal[i] = BAND(banda, i, i);
+            super[i] = (i < n - 1) ? BAND(banda, i, i + 1) : 0.0;
+        }
+        memcpy(x_serial, x, sizeof(double) * n);
+
+        // Referência: LU de banda com pivoteamento, sequencial
+        inicio = omp_get_wtime();
+        info = ppc_band_getrf(banda, pivos);
+        if (info == 0)
+            ppc_band_getrs(banda, pivos, x_serial);
+        double tempo_serial = omp_get_wtime() - inicio;
+
+        // Início da medição de tempo
+        inicio = omp_get_wtime();
+
+        if (info == 0)
+            info = ppc_tridiagonal_solve(n, sub, diagonal, super, x);
+
+        // Fim da medição de tempo
+        tempo_execucao = omp_get_wtime() - inicio;
+
+        if (info == 0)
+        {
+            double diferenca = 0.0;
+            for (long int i = 0; i < n; i++)
+                if (fabs(x[i] - x_serial[i]) > diferenca)
+                    diferenca = fabs(x[i] - x_serial[i]);
+
+            printf("\nLU de banda (sequencial): %.6f segundos\n", tempo_serial);
+            printf("Tridiagonal particionado: %.6f segundos (%.2fx)\n", tempo_execucao, tempo_serial / tempo_execucao);
+            printf("Diferença máxima entre as soluções: %.3e\n", diferenca);
+        }
+
+        free(sub);
+        free(diagonal);
+        free(super);
+        free(x_serial);
+        free(pivos);
+    }
+    else
+    {
+        int *pivos = (int *)malloc(sizeof(int) * n);
+
+        // Início da medição de tempo
+        inicio = omp_get_wtime();
+
+        info = ppc_band_getrf(banda, pivos);
+        if (info == 0)
+            ppc_band_getrs(banda, pivos, x);
+
+        // Fim da medição de tempo
+        tempo_execucao = omp_get_wtime() - inicio;
+
+        free(pivos);
+    }
+
+    if (info != 0)
+    {
+        fprintf(stderr, "Erro: Pivô zero na linha %d; o sistema não tem solução única.\n", info - 1);
+        free_band_matrix(banda);
+        free(uns);
+        free(x);
+        return 1;
+    }
+
+    double erro = 0.0;
+    for (long int i = 0; i < n; i++)
+        if (fabs(x[i] - 1.0) > erro)
+            erro = fabs(x[i] - 1.0);
+
+    printf("\nSolução x (primeiros elementos):");
+    print_double_vector(x, n < 10 ? n : 10, 10);
+
+    printf("\nErro máximo |x - 1|: %.3e\n", erro);
+    printf("Tempo de execução (%s): %.6f segundos\n", tridiagonal ? "tridiagonal" : "LU de banda", tempo_execucao);
+
+    save_double_vector(x, n, "solucao_paralelo.out");
+    printf("Solução salva em: solucao_paralelo.out\n");
+
+    free_band_matrix(banda);
+    free(uns);
+    free(x);
+
+    return 0;
+}
+
 int main(int argc, char *argv[])
 {
     // Valida argumentos passados via terminal
     if (argc < 3)
     {
-        fprintf(stderr, "Uso: %s <ordem> <arquivo_entrada>\n", argv[0]);
+        fprintf(stderr, "Uso: %s <ordem> <arquivo_entrada> [modo] [ladrilho | largura | colunas [arquivo_b] | arquivo_b [colunas_b]]\n", argv[0]);
+        fprintf(stderr, "Modos: classico (padrão), persistente, pivotado, lu, lu_tarefas [ladrilho], cholesky, resolver [arquivo_b [colunas_b]], resolver_misto [arquivo_b [colunas_b]], inversa, banda [largura], tridiagonal, qr [colunas [arquivo_b]], tsqr [colunas [arquivo_b]], autotune\n");
         fprintf(stderr, "Exemplo: %s 100 matriz.in\n", argv[0]);
         return 1;
     }
 
     int ordem = atol(argv[1]);
     char *arquivo_entrada = argv[2];
+    const char *modo = (argc > 3) ? argv[3] : "classico";
+    long int ladrilho = (argc > 4 && strcmp(modo, "lu_tarefas") == 0) ? atol(argv[4]) : LADRILHO_LU;
+    int resolve = strcmp(modo, "resolver") == 0 || strcmp(modo, "resolver_misto") == 0;
+    int minimos_quadrados = strcmp(modo, "qr") == 0 || strcmp(modo, "tsqr") == 0;
+    const char *arquivo_b = (argc > 4 && resolve) ? argv[4] : (argc > 5 && minimos_quadrados) ? argv[5] : "b.in";
+    long int colunas = (argc > 4 && minimos_quadrados) ? atol(argv[4]) : COLUNAS_QR;
+    int banda = strcmp(modo, "banda") == 0 || strcmp(modo, "tridiagonal") == 0;
+    long int largura = (argc > 4 && strcmp(modo, "banda") == 0) ? atol(argv[4]) : LARGURA_BANDA;
+    long int colunas_b = (argc > 5 && resolve) ? atol(argv[5]) : 1;
 
     if (ordem <= 0)
     {
@@ -51,33 +1196,177 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    if (strcmp(modo, "classico") != 0 && strcmp(modo, "persistente") != 0 && strcmp(modo, "pivotado") != 0 &&
+        strcmp(modo, "lu") != 0 && strcmp(modo, "lu_tarefas") != 0 && strcmp(modo, "cholesky") != 0 &&
+        strcmp(modo, "inversa") != 0 && !resolve && !banda && !minimos_quadrados && strcmp(modo, "autotune") != 0)
+    {
+        fprintf(stderr, "Erro: Modo desconhecido '%s'.\n", modo);
+        return 1;
+    }
+
+    if (ladrilho <= 0)
+    {
+        fprintf(stderr, "Erro: O ladrilho deve ser um número positivo!\n");
+        return 1;
+    }
+
+    // O tsqr fatora [A b], que precisa ter pelo menos tantas linhas quanto
+    // colunas: A tem no máximo ordem - 1 colunas
+    long int max_colunas = (strcmp(modo, "tsqr") == 0) ? ordem - 1 : ordem;
+
+    if (minimos_quadrados && argc <= 4 && colunas > max_colunas)
+        colunas = max_colunas;
+
+    if (minimos_quadrados && max_colunas < 1)
+    {
+        fprintf(stderr, "Erro: O modo tsqr precisa de ordem maior que 1!\n");
+        return 1;
+    }
+
+    if (minimos_quadrados && (colunas <= 0 || colunas > max_colunas))
+    {
+        fprintf(stderr, "Erro: A matriz deve ter entre 1 e %ld colunas!\n", max_colunas);
+        return 1;
+    }
+
+    if (largura < 0)
+    {
+        fprintf(stderr, "Erro: A largura da banda não pode ser negativa!\n");
+        return 1;
+    }
+
+    if (colunas_b <= 0)
+    {
+        fprintf(stderr, "Erro: O número de lados direitos deve ser positivo!\n");
+        return 1;
+    }
+
+    // Limite paralelo e threads ajustados para esta ordem pelo modo autotune,
+    // se houver perfil
+    int limite_paralelo = ppc_profile_get("triangulacao_limite_paralelo", ordem, LIMITE_PARALELO);
+    if (strcmp(modo, "autotune") != 0)
+        ppc_profile_apply_threads("triangulacao_threads", ordem);
+
     printf("Eliminação Gaussiana (Paralelo)\n");
-    printf("Ordem da matriz: %dx%d\n", ordem, ordem);
+    if (minimos_quadrados)
+        printf("Ordem da matriz: %dx%ld\n", ordem, colunas);
+    else
+        printf("Ordem da matriz: %dx%d\n", ordem, ordem);
     printf("Matriz: %s\n", arquivo_entrada);
+    printf("Modo: %s\n", modo);
+    if (strcmp(modo, "lu_tarefas") == 0)
+        printf("Ladrilho: %ldx%ld\n", ladrilho, ladrilho);
+    else if (resolve)
+        printf("Lados direitos: %s (%ld)\n", arquivo_b, colunas_b);
+    else if (strcmp(modo, "banda") == 0)
+        printf("Largura da banda: %ld\n", largura);
+    else if (minimos_quadrados)
+        printf("Lado direito: %s\n", arquivo_b);
+    else if (strcmp(modo, "classico") == 0 || strcmp(modo, "pivotado") == 0)
+        printf("Limite paralelo: %d linhas\n", limite_paralelo);
     printf("Número de threads disponíveis: %d\n", omp_get_max_threads());
+
+    if (ppc_pin_threads())
+        printf("Afinidade: threads fixadas em CPUs (spread)\n");
+    else
+        printf("Afinidade: definida pelo runtime OpenMP (OMP_PROC_BIND/OMP_PLACES)\n");
     printf("\n");
 
+    // Sistemas de banda não passam pela matriz densa
+    if (banda)
+        return executar_banda(arquivo_entrada, ordem, largura, strcmp(modo, "tridiagonal") == 0);
+
+    // Nem os de mínimos quadrados, com ordem x colunas elementos
+    if (minimos_quadrados)
+        return executar_minimos_quadrados(arquivo_entrada, ordem, colunas, arquivo_b, strcmp(modo, "tsqr") == 0);
+
+    // Linhas tocadas pela primeira vez em paralelo, em faixas estáticas
     double *matriz;
     if (access(arquivo_entrada, F_OK) == 0)
     {
         printf("Carregando matriz do arquivo...\n");
-        matriz = load_double_matrix(arquivo_entrada, ordem, ordem);
+        matriz = load_double_matrix_first_touch(arquivo_entrada, ordem, ordem, 1);
+    }
+    else if (strcmp(modo, "cholesky") == 0)
+    {
+        printf("Gerando matriz simétrica positiva definida aleatória...\n");
+        matriz = generate_random_spd_matrix(ordem);
+        save_double_matrix(matriz, ordem, ordem, arquivo_entrada);
     }
     else
     {
         printf("Gerando matriz aleatória...\n");
-        matriz = generate_random_double_matrix(ordem, ordem);
+        matriz = generate_random_double_matrix_first_touch(ordem, ordem, 1);
         save_double_matrix(matriz, ordem, ordem, arquivo_entrada);
     }
 
+    if (matriz == NULL)
+    {
+        fprintf(stderr, "Erro: Não foi possível carregar a matriz.\n");
+        return 1;
+    }
+
+    if (strcmp(modo, "autotune") == 0)
+    {
+        printf("\n");
+        autoajustar(matriz, ordem);
+        free(matriz);
+        return 0;
+    }
+
     printf("\nMatriz original:\n");
     print_double_matrix(matriz, ordem, ordem);
     printf("\n");
 
+    if (strcmp(modo, "lu") == 0 || strcmp(modo, "lu_tarefas") == 0)
+    {
+        int resultado = executar_lu(matriz, ordem, strcmp(modo, "lu_tarefas") == 0 ? ladrilho : 0);
+        free(matriz);
+        return resultado;
+    }
+
+    if (strcmp(modo, "pivotado") == 0)
+    {
+        int resultado = executar_pivotado(matriz, ordem, limite_paralelo);
+        free(matriz);
+        return resultado;
+    }
+
+    if (strcmp(modo, "inversa") == 0)
+    {
+        int resultado = executar_inversa(matriz, ordem);
+        free(matriz);
+        return resultado;
+    }
+
+    if (strcmp(modo, "cholesky") == 0)
+    {
+        int resultado = executar_cholesky(matriz, ordem);
+        free(matriz);
+        return resultado;
+    }
+
+    if (strcmp(modo, "resolver") == 0)
+    {
+        int resultado = executar_resolver(matriz, ordem, arquivo_b, colunas_b);
+        free(matriz);
+        return resultado;
+    }
+
+    if (strcmp(modo, "resolver_misto") == 0)
+    {
+        int resultado = executar_resolver_misto(matriz, ordem, arquivo_b, colunas_b);
+        free(matriz);
+        return resultado;
+    }
+
     // Início da medição de tempo
     double inicio = omp_get_wtime();
 
-    eliminacao_gaussiana_paralela(matriz, ordem, ordem);
+    if (strcmp(modo, "persistente") == 0)
+        eliminacao_gaussiana_persistente(matriz, ordem, ordem);
+    else
+        eliminacao_gaussiana_paralela(matriz, ordem, ordem, limite_paralelo);
 
     // Fim da medição de tempo
     double fim = omp_get_wtime();
@@ -88,6 +1377,9 @@ int main(int argc, char *argv[])
     printf("\n");
     printf("Tempo de execução (multiplicação): %.6f segundos\n", tempo_execucao);
 
+    printf("Páginas por nó NUMA:\n");
+    imprimir_distribuicao_numa("Matriz", matriz, (long int)ordem * ordem);
+
     save_double_matrix(matriz, ordem, ordem, "saida_paralelo.out");
     printf("Matriz resultado salva em: saida_paralelo.out\n");
 